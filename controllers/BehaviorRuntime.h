@@ -0,0 +1,447 @@
+/**
+ * @file BehaviorRuntime.h
+ * @brief Runs multi-step device behaviors as C++20 coroutines on simulated time.
+ *
+ * A device behavior such as "ramp the fan up over 30s" is written as a coroutine
+ * returning `Behavior` that suspends on simulated-time awaitables:
+ *
+ *     Behavior blink(Light& light, int times) {
+ *         for (int i = 0; i < times; ++i) {
+ *             light.toggle();
+ *             co_await sleepFor(SimClock::SECOND);
+ *         }
+ *     }
+ *
+ * `BehaviorRuntime::start()` takes ownership of the coroutine and runs it up to
+ * its first suspension. A suspended behavior is appended to the bucket of its
+ * wake-up instant; a small min-heap orders the distinct instants. update()
+ * resumes exactly the behaviors due by the given time, one whole bucket per
+ * instant, so a suspended behavior costs nothing per tick and no thread is
+ * involved. Behaviors stepping on round times share buckets, which keeps the
+ * heap far smaller than the number of behaviors. The CLI interleaves these
+ * instants with the Scheduler's.
+ *
+ * Behaviors live in slots with generations, like Scheduler tasks: a BehaviorId
+ * packs the slot and its generation, cancelling frees the slot at once and the
+ * bucket entry is skipped lazily. A device runs at most one behavior; starting a
+ * new one on the same device cancels the previous one. Coroutine frames come
+ * from the `FramePool`.
+ *
+ * Design Pattern:
+ * - Command Pattern: each behavior is a resumable unit of device work scheduled by the runtime
+ *
+ * Responsibilities:
+ * - Own behavior coroutines and resume them at their wake-up times
+ * - Apply the changes of one instant in one notification batch
+ * - Cancel behaviors by ID or by device and reclaim their frames
+ */
+
+#ifndef BEHAVIOR_RUNTIME_H
+#define BEHAVIOR_RUNTIME_H
+
+#include <algorithm>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../models/SmartDevice.h"
+#include "../utils/FramePool.h"
+#include "../utils/SimClock.h"
+
+class BehaviorRuntime;
+
+/**
+ * @brief Coroutine type of a device behavior.
+ *
+ * A Behavior is created suspended and owns its frame until it is handed to
+ * BehaviorRuntime::start().
+ */
+class Behavior {
+public:
+    struct promise_type {
+        BehaviorRuntime* runtime = nullptr;  ///< Set by BehaviorRuntime::start()
+        uint32_t slot = 0;
+
+        Behavior get_return_object() {
+            return Behavior(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }  // The runtime destroys finished frames
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return FramePool::instance().allocate(size); }
+        static void operator delete(void* p, size_t size) { FramePool::instance().deallocate(p, size); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Behavior(Behavior&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Behavior(const Behavior&) = delete;
+    Behavior& operator=(const Behavior&) = delete;
+    ~Behavior() { if (handle) handle.destroy(); }
+
+    /**
+     * @brief Gives up ownership of the coroutine.
+     */
+    Handle release() { return std::exchange(handle, nullptr); }
+
+private:
+    explicit Behavior(Handle h) : handle(h) {}
+    Handle handle;
+};
+
+/**
+ * @brief Awaitable that resumes a behavior at an absolute simulated time.
+ *
+ * Times at or before the current instant resume at the current instant, after
+ * the behaviors already due then.
+ */
+struct SleepUntil {
+    SimTime wake;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behavior::Handle h) const;
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Awaitable that resumes a behavior after a simulated duration.
+ *
+ * The duration is measured from the instant the behavior is running at.
+ */
+struct SleepFor {
+    SimTime duration;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behavior::Handle h) const;
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Suspends the calling behavior until `time`.
+ */
+inline SleepUntil sleepUntil(SimTime time) { return SleepUntil{time}; }
+
+/**
+ * @brief Suspends the calling behavior for `duration` of simulated time.
+ */
+inline SleepFor sleepFor(SimTime duration) { return SleepFor{duration}; }
+
+class BehaviorRuntime {
+public:
+    using BehaviorId = uint64_t;
+    static constexpr BehaviorId INVALID_BEHAVIOR = ~BehaviorId(0);
+    static constexpr SimTime NEVER = -1;  ///< nextDue() when no behavior is waiting
+
+    /**
+     * @brief Cumulative counters.
+     */
+    struct Stats {
+        uint64_t started = 0;
+        uint64_t finished = 0;
+        uint64_t cancelled = 0;
+        uint64_t resumes = 0;   ///< Coroutine resumptions, including the first run
+        uint64_t instants = 0;  ///< Distinct instants at which behaviors were resumed
+    };
+
+private:
+    static constexpr uint32_t NO_BUCKET = ~uint32_t(0);
+
+    /**
+     * @brief A running behavior; free when handle is null.
+     */
+    struct Slot {
+        Behavior::Handle handle;
+        SmartDevice* device = nullptr;
+        const char* label = "";         ///< Static description, e.g. "fan ramp"
+        SimTime wake = 0;               ///< Time of the pending wake-up
+        uint32_t bucket = NO_BUCKET;    ///< Bucket holding the pending wake-up
+        uint32_t generation = 0;        ///< Incremented each time the slot is freed
+    };
+
+    /**
+     * @brief A sleeping behavior; stale once the slot's generation moved on.
+     */
+    struct Waiter {
+        uint32_t slot;
+        uint32_t generation;
+    };
+
+    /**
+     * @brief Behaviors waking at one instant, in the order they went to sleep.
+     */
+    struct Bucket {
+        std::vector<Waiter> waiters;
+        uint32_t live = 0;  ///< Waiters not cancelled since
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<Bucket> buckets;
+    std::vector<uint32_t> freeBuckets;
+    std::unordered_map<SimTime, uint32_t> bucketOf;  ///< Instant -> bucket
+    std::vector<SimTime> instants;                   ///< Min-heap of the instants in bucketOf
+    SimTime lastInstant = NEVER;                     ///< Cache of the last bucketOf lookup
+    uint32_t lastBucket = NO_BUCKET;
+    std::vector<Waiter> ready;                       ///< Behaviors resumed at the current instant
+    std::vector<BehaviorId> byDevice;                ///< Running behavior per device handle
+    SimTime current = 0;                             ///< Instant the running behaviors are resumed at
+    Stats stats;
+
+    friend struct SleepUntil;
+    friend struct SleepFor;
+
+public:
+    BehaviorRuntime() = default;
+    BehaviorRuntime(const BehaviorRuntime&) = delete;
+    BehaviorRuntime& operator=(const BehaviorRuntime&) = delete;
+
+    /**
+     * @brief Destroys the frames of all behaviors still running.
+     */
+    ~BehaviorRuntime() {
+        for (Slot& s : slots) {
+            if (s.handle) s.handle.destroy();
+        }
+    }
+
+    /**
+     * @brief Starts a behavior on a device and runs it up to its first suspension.
+     *
+     * A behavior already running on the device is cancelled first. The behavior
+     * starts at SimClock::now().
+     *
+     * @param behavior The coroutine; the runtime takes ownership
+     * @param device Device the behavior drives
+     * @param label Static description shown by printBehaviors()
+     * @return The behavior's ID, or INVALID_BEHAVIOR if it finished without suspending
+     */
+    BehaviorId start(Behavior behavior, SmartDevice* device, const char* label) {
+        size_t d = static_cast<size_t>(device->getId());
+        if (d >= byDevice.size()) byDevice.resize(d + 1, INVALID_BEHAVIOR);
+        cancel(byDevice[d]);
+
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        Slot& s = slots[slot];
+        s.handle = behavior.release();
+        s.device = device;
+        s.label = label;
+        s.handle.promise().runtime = this;
+        s.handle.promise().slot = slot;
+        stats.started++;
+
+        BehaviorId id = behaviorId(slot);
+        byDevice[d] = id;
+        current = SimClock::now();
+        resume(slot);
+        return isLive(id) ? id : INVALID_BEHAVIOR;
+    }
+
+    /**
+     * @brief Cancels a behavior, destroying its frame. The device keeps its current state.
+     * @return true if the behavior was running
+     */
+    bool cancel(BehaviorId id) {
+        if (!isLive(id)) return false;
+        release(static_cast<uint32_t>(id & 0xFFFFFFFFu));
+        stats.cancelled++;
+        return true;
+    }
+
+    /**
+     * @brief Cancels the behavior running on a device, if any.
+     */
+    bool cancelDevice(const SmartDevice* device) {
+        size_t d = static_cast<size_t>(device->getId());
+        return d < byDevice.size() && cancel(byDevice[d]);
+    }
+
+    /**
+     * @brief Cancels every running behavior (used on reset).
+     */
+    void cancelAll() {
+        for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+            if (slots[slot].handle) {
+                release(slot);
+                stats.cancelled++;
+            }
+        }
+        while (!instants.empty()) dropFront();
+    }
+
+    /**
+     * @brief Returns the earliest wake-up time, or NEVER if no behavior is waiting.
+     */
+    SimTime nextDue() {
+        while (!instants.empty() && buckets[bucketOf[instants.front()]].live == 0) dropFront();
+        return instants.empty() ? NEVER : instants.front();
+    }
+
+    /**
+     * @brief Resumes the behaviors due by `currentTime`, one instant at a time.
+     *
+     * The behaviors due at one instant are resumed in the order they went to
+     * sleep, inside one notification batch. Behaviors that sleep until that same
+     * instant again run after them, before the next instant. Callers that need
+     * observers to see each instant's own timestamp step through nextDue(), as
+     * with the Scheduler.
+     *
+     * @param currentTime The current simulated time
+     */
+    void update(SimTime currentTime) {
+        for (SimTime instant = nextDue(); instant != NEVER && instant <= currentTime; instant = nextDue()) {
+            ready.clear();
+            ready.swap(buckets[bucketOf[instant]].waiters);
+            dropFront();
+            for (const Waiter& w : ready) {
+                if (slots[w.slot].generation == w.generation) slots[w.slot].bucket = NO_BUCKET;
+            }
+
+            current = instant;
+            stats.instants++;
+            SmartDevice::beginNotificationBatch();
+            for (const Waiter& w : ready) {
+                if (slots[w.slot].generation == w.generation) resume(w.slot);
+            }
+            SmartDevice::endNotificationBatch();
+        }
+    }
+
+    /**
+     * @brief Returns the number of running behaviors.
+     */
+    size_t liveBehaviors() const { return slots.size() - freeSlots.size(); }
+
+    /**
+     * @brief Returns the cumulative counters.
+     */
+    const Stats& getStats() const { return stats; }
+
+    /**
+     * @brief Prints counters, frame pool usage and the first running behaviors.
+     */
+    void printBehaviors() const {
+        const FramePool::Stats& pool = FramePool::instance().getStats();
+        std::cout << "\n=== Device Behaviors (" << liveBehaviors() << " running) ===\n"
+                  << "started " << stats.started << ", finished " << stats.finished
+                  << ", cancelled " << stats.cancelled << ", " << stats.resumes << " resumes at "
+                  << stats.instants << " instants\n"
+                  << "frames: " << pool.live << " live, " << pool.allocations << " allocated ("
+                  << pool.reused << " reused), " << pool.chunkBytes / 1024 << " KiB pooled\n";
+        int shown = 0;
+        for (const Slot& s : slots) {
+            if (!s.handle) continue;
+            if (shown++ == 20) {
+                std::cout << "...\n";
+                break;
+            }
+            std::cout << "- " << s.device->getName() << ": " << s.label
+                      << ", next step at t=" << SimClock::format(s.wake) << "\n";
+        }
+        std::cout << "==================================\n";
+    }
+
+private:
+    void resume(uint32_t slot) {
+        stats.resumes++;
+        Behavior::Handle h = slots[slot].handle;
+        h.resume();
+        if (h.done()) {
+            stats.finished++;
+            release(slot);
+        }
+    }
+
+    /**
+     * @brief Puts a suspended behavior into the bucket of its wake-up instant.
+     */
+    void enqueue(uint32_t slot, SimTime due) {
+        if (due != lastInstant) {
+            auto [it, inserted] = bucketOf.try_emplace(due, NO_BUCKET);
+            if (inserted) {
+                if (freeBuckets.empty()) {
+                    it->second = static_cast<uint32_t>(buckets.size());
+                    buckets.emplace_back();
+                } else {
+                    it->second = freeBuckets.back();
+                    freeBuckets.pop_back();
+                }
+                instants.push_back(due);
+                std::push_heap(instants.begin(), instants.end(), std::greater<SimTime>());
+            }
+            lastInstant = due;
+            lastBucket = it->second;
+        }
+        Slot& s = slots[slot];
+        s.wake = due;
+        s.bucket = lastBucket;
+        buckets[lastBucket].waiters.push_back(Waiter{slot, s.generation});
+        buckets[lastBucket].live++;
+    }
+
+    /**
+     * @brief Removes the earliest instant and recycles its bucket.
+     */
+    void dropFront() {
+        SimTime instant = instants.front();
+        std::pop_heap(instants.begin(), instants.end(), std::greater<SimTime>());
+        instants.pop_back();
+        auto it = bucketOf.find(instant);
+        Bucket& b = buckets[it->second];
+        b.waiters.clear();
+        b.live = 0;
+        freeBuckets.push_back(it->second);
+        bucketOf.erase(it);
+        if (instant == lastInstant) lastInstant = NEVER;
+    }
+
+    /**
+     * @brief Frees a slot: destroys its frame, invalidates its ID and withdraws its wake-up.
+     */
+    void release(uint32_t slot) {
+        Slot& s = slots[slot];
+        size_t d = static_cast<size_t>(s.device->getId());
+        if (byDevice[d] == behaviorId(slot)) byDevice[d] = INVALID_BEHAVIOR;
+        if (s.bucket != NO_BUCKET) buckets[s.bucket].live--;
+        s.handle.destroy();
+        s.handle = nullptr;
+        s.device = nullptr;
+        s.bucket = NO_BUCKET;
+        s.generation++;
+        freeSlots.push_back(slot);
+    }
+
+    BehaviorId behaviorId(uint32_t slot) const {
+        return (static_cast<BehaviorId>(slots[slot].generation) << 32) | slot;
+    }
+
+    bool isLive(BehaviorId id) const {
+        uint32_t slot = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        return slot < slots.size() && slots[slot].handle && slots[slot].generation == static_cast<uint32_t>(id >> 32);
+    }
+};
+
+inline void SleepUntil::await_suspend(Behavior::Handle h) const {
+    BehaviorRuntime& runtime = *h.promise().runtime;
+    runtime.enqueue(h.promise().slot, std::max(wake, runtime.current));
+}
+
+inline void SleepFor::await_suspend(Behavior::Handle h) const {
+    BehaviorRuntime& runtime = *h.promise().runtime;
+    runtime.enqueue(h.promise().slot, runtime.current + std::max<SimTime>(duration, 0));
+}
+
+#endif // BEHAVIOR_RUNTIME_H
@@ -10,19 +10,25 @@
  * - Maintain a registry of active devices
  * - Provide interface to toggle device states by name
  * - Display a list of current devices and their statuses
+ * - Look devices up by handle and keep per-type membership bitsets
  *
  */
 
 #ifndef DEVICE_CONTROLLER_H
 #define DEVICE_CONTROLLER_H
 
+#include <cctype>
 #include <vector>
 #include <string>
 #include <iostream>
 #include "../models/SmartDevice.h"
+#include "../utils/DeviceSet.h"
 
 class DeviceController {
     std::vector<SmartDevice*> devices;  ///< Collection of all registered smart devices
+    std::vector<SmartDevice*> byId;     ///< Device handle -> device (nullptr if not registered)
+    std::vector<std::string> typeNames; ///< Known device types
+    std::vector<DeviceSet> typeSets;    ///< Handles of the devices of each type (parallel to typeNames)
 
 public:
     /**
@@ -31,6 +37,17 @@ public:
      */
     void addDevice(SmartDevice* d) {
         devices.push_back(d);
+        int id = d->getId();
+        if (id >= static_cast<int>(byId.size())) byId.resize(id + 1, nullptr);
+        byId[id] = d;
+
+        size_t t = 0;
+        while (t < typeNames.size() && typeNames[t] != d->getType()) t++;
+        if (t == typeNames.size()) {
+            typeNames.push_back(d->getType());
+            typeSets.emplace_back();
+        }
+        typeSets[t].set(id);
     }
 
     /**
@@ -51,6 +68,40 @@ public:
         std::cout << "Device \"" << name << "\" not found!" << std::endl;
     }
 
+    /**
+     * @brief Finds a registered device by name.
+     * @param name The name of the device to locate
+     * @return Pointer to the SmartDevice, or nullptr if not found
+     */
+    SmartDevice* findDevice(const std::string& name) const {
+        for (auto* d : devices) {
+            if (d->getName() == name) return d;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Finds a registered device by handle.
+     * @param id Handle as returned by SmartDevice::getId()
+     * @return Pointer to the SmartDevice, or nullptr if not registered
+     */
+    SmartDevice* getDeviceById(int id) const {
+        return id >= 0 && id < static_cast<int>(byId.size()) ? byId[id] : nullptr;
+    }
+
+    /**
+     * @brief Returns the handles of all devices of a type.
+     * @param type Type name, case-insensitive and optionally plural (e.g., "lights")
+     * @return The membership bitset, or nullptr if no device has that type
+     */
+    const DeviceSet* devicesOfType(const std::string& type) const {
+        std::string wanted = normalizeType(type);
+        for (size_t t = 0; t < typeNames.size(); ++t) {
+            if (normalizeType(typeNames[t]) == wanted) return &typeSets[t];
+        }
+        return nullptr;
+    }
+
     /**
      * @brief Lists all registered smart devices and their current states.
      */
@@ -72,6 +123,12 @@ public:
     return devices;
 }
 
+private:
+    static std::string normalizeType(std::string type) {
+        for (auto& c : type) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (type.size() > 1 && type.back() == 's') type.pop_back();
+        return type;
+    }
 };
 
 #endif // DEVICE_CONTROLLER_H
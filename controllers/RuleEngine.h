@@ -0,0 +1,636 @@
+/**
+ * @file RuleEngine.h
+ * @brief User-defined automation rules compiled into an incremental match network in SmartHomeSim.
+ *
+ * The `RuleEngine` class lets users describe device behavior as rules instead of
+ * hard-coded C++, e.g.:
+ *
+ *     if temp > 30 and time between 22:00-06:00 then Bedroom Fan ON
+ *
+ * Grammar (one rule per line, keywords are case-insensitive):
+ *
+ *     rule      := "if" condition { "and" condition } "then" <device name> ("ON" | "OFF")
+ *     condition := <sensor-id | sensor kind> <op> <number>        op: > >= < <= == !=
+ *                | "time between" HH:MM "-" HH:MM                 (may wrap past midnight)
+ *                | <device name> "is" ("ON" | "OFF")
+ *
+ * Rules are compiled once. Sensor IDs, kinds and device names are resolved to
+ * slots in a flat fact table or to device pointers, and each condition becomes
+ * one fixed-size instruction. Matching is incremental, in the style of a Rete network:
+ * - Alpha nodes: each distinct condition is stored once and shared by every rule
+ *   that uses it. The node caches its truth value.
+ * - Fact index: per fact, the comparison nodes are sorted by their constant. A
+ *   change from `old` to `new` only re-tests the nodes whose constant lies between
+ *   the two values (plus equality nodes on either value and time windows).
+ * - Rules: each rule counts how many of its alpha nodes hold. A flipped node only
+ *   adjusts the counters of its own rules, and a rule fires when its counter
+ *   reaches its condition count, i.e. on the transition from unsatisfied to satisfied.
+ *
+ * The cost of an event is therefore proportional to the conditions and rules it
+ * actually affects, not to the number of rules loaded.
+ *
+ * A sensor or kind that has not reported yet holds no value (NaN in the fact
+ * table), and no condition on it holds, `!=` included.
+ *
+ * Responsibilities:
+ * - Parse and compile rules from the CLI or from a file
+ * - Maintain the fact table (sensor values, time of day, device states)
+ * - Propagate fact changes through the alpha nodes to the affected rules only
+ * - Apply the actions of rules that became satisfied and report the cost per event
+ *
+ * Design Pattern:
+ * - Observer Pattern: subscribes to sensors as a `SensorListener` and to the
+ *   devices named in conditions as an `Observer`
+ */
+
+#ifndef RULE_ENGINE_H
+#define RULE_ENGINE_H
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DeviceController.h"
+#include "../models/SmartDevice.h"
+#include "../models/sensor/SensorRegistry.h"
+#include "../observers/Observer.h"
+#include "../observers/SubscriptionTable.h"
+#include "../utils/SimClock.h"
+
+class RuleEngine : public SensorListener, public Observer {
+public:
+    /**
+     * @brief Condition opcodes.
+     */
+    enum class Op : uint8_t {
+        Gt, Ge, Lt, Le, Eq, Ne,   ///< facts[slot] <op> a
+        InRange,                  ///< a <= facts[slot] < b
+        OutRange,                 ///< facts[slot] >= a || facts[slot] < b (wrapping window)
+        DeviceOn, DeviceOff       ///< deviceTable[slot]->getState() is on / off
+    };
+
+    /**
+     * @brief One compiled condition.
+     */
+    struct Instruction {
+        Op op;
+        uint32_t slot;   ///< Fact slot or device-table index
+        float a;
+        float b;
+
+        bool operator==(const Instruction& o) const {
+            return op == o.op && slot == o.slot && a == o.a && b == o.b;
+        }
+    };
+
+    /**
+     * @brief One compiled rule: a satisfied-condition counter and an action.
+     */
+    struct CompiledRule {
+        uint32_t needed = 0;           ///< Number of distinct conditions
+        uint32_t satisfied = 0;        ///< Conditions currently holding
+        SmartDevice* target = nullptr; ///< Device to set
+        bool turnOn = false;           ///< State to set it to
+    };
+
+    /**
+     * @brief Matching counters.
+     */
+    struct Stats {
+        long long events = 0;          ///< Fact-change events processed
+        long long alphaTests = 0;      ///< Conditions re-tested
+        long long ruleUpdates = 0;     ///< Rule counter adjustments
+        long long firings = 0;         ///< Rules that became satisfied
+        long long nanoseconds = 0;     ///< Time spent matching
+    };
+
+private:
+    /**
+     * @brief A shared condition, its cached truth value and the rules reading it.
+     */
+    struct AlphaNode {
+        Instruction cond;
+        bool truth;
+        std::vector<uint32_t> rules;
+    };
+
+    /**
+     * @brief Alpha nodes that read one fact slot.
+     */
+    struct FactIndex {
+        std::vector<std::pair<float, uint32_t>> ordered;   ///< Gt/Ge/Lt/Le nodes by constant
+        std::vector<std::pair<float, uint32_t>> equality;  ///< Eq/Ne nodes by constant
+        std::vector<uint32_t> windows;                     ///< InRange/OutRange nodes
+        bool sorted = true;                                ///< false after nodes were appended
+    };
+
+    struct InstructionHash {
+        size_t operator()(const Instruction& in) const {
+            uint32_t a, b;
+            std::memcpy(&a, &in.a, 4);
+            std::memcpy(&b, &in.b, 4);
+            uint64_t h = (static_cast<uint64_t>(in.slot) << 8) ^ static_cast<uint64_t>(in.op);
+            h = (h ^ a) * 0x9E3779B97F4A7C15ull;
+            h = (h ^ b) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    static constexpr uint32_t TIME_SLOT = SENSOR_KIND_COUNT;   ///< Time of day (seconds)
+    static constexpr uint32_t FIRST_SENSOR_SLOT = TIME_SLOT + 1;
+    static constexpr float UNSEEN = std::numeric_limits<float>::quiet_NaN();  ///< Fact with no value yet
+    static constexpr int MAX_CASCADE = 16;                     ///< Nested rule firings allowed
+
+    DeviceController& controller;
+    SensorRegistry& sensors;
+    std::vector<float> facts;                                  ///< [kinds..., time of day, sensors...]
+    std::vector<FactIndex> factIndex;                          ///< Fact slot -> alpha nodes
+    std::vector<SmartDevice*> deviceTable;                     ///< Devices referenced by DeviceOn/Off
+    std::vector<std::vector<uint32_t>> deviceIndex;            ///< Device handle -> alpha nodes
+    std::vector<bool> observedDevices;                         ///< Device handle -> subscribed yet
+    std::vector<AlphaNode> alpha;                              ///< Shared conditions
+    std::unordered_map<Instruction, uint32_t, InstructionHash> alphaLookup;
+    std::vector<CompiledRule> rules;                           ///< Rules in definition order
+    std::vector<std::string> sources;                          ///< Rule text, for listing
+    std::vector<uint32_t> rises, falls;                        ///< Scratch: nodes flipped by an event
+    std::vector<std::pair<SmartDevice*, bool>> actions;        ///< Actions of rules that became satisfied
+    int cascadeDepth = 0;
+    Stats stats;
+
+public:
+    /**
+     * @brief Constructs an engine resolving names against the given registries.
+     */
+    RuleEngine(DeviceController& devices, SensorRegistry& registry)
+        : controller(devices), sensors(registry), facts(FIRST_SENSOR_SLOT, UNSEEN), factIndex(FIRST_SENSOR_SLOT) {
+        facts[TIME_SLOT] = timeOfDay(SimClock::now());
+    }
+
+    /**
+     * @brief Compiles and adds a rule. A rule that already holds fires immediately.
+     * @param text Rule source
+     * @param error Receives a message if the rule is rejected
+     * @return true if the rule was added
+     */
+    bool addRule(const std::string& text, std::string& error) {
+        CompiledRule rule;
+        std::vector<Instruction> compiled;
+        if (!compile(text, compiled, rule, error)) return false;
+
+        uint32_t index = static_cast<uint32_t>(rules.size());
+        for (const Instruction& in : compiled) {
+            AlphaNode& node = alpha[alphaNode(in)];
+            if (!node.rules.empty() && node.rules.back() == index) continue;  // Repeated condition
+            node.rules.push_back(index);
+            rule.needed++;
+            if (node.truth) rule.satisfied++;
+        }
+        rules.push_back(rule);
+        sources.push_back(text);
+
+        if (rule.satisfied == rule.needed) {
+            actions.push_back({rule.target, rule.turnOn});
+            stats.firings++;
+            applyActions();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Loads rules from a file, one per line (blank lines and # comments skipped).
+     * @return Number of rules added
+     */
+    int loadFile(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            std::cout << "[Rules] Error: cannot open \"" << path << "\".\n";
+            return 0;
+        }
+        int added = 0, lineNo = 0;
+        std::string line, error;
+        while (std::getline(in, line)) {
+            lineNo++;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == std::string::npos || line[line.find_first_not_of(" \t")] == '#') continue;
+            if (addRule(line, error)) added++;
+            else std::cout << "[Rules] " << path << ":" << lineNo << ": " << error << "\n";
+        }
+        return added;
+    }
+
+    /**
+     * @brief Removes all rules and conditions. Facts are kept.
+     */
+    void clear() {
+        for (auto& index : factIndex) index = FactIndex{};
+        for (auto& nodes : deviceIndex) nodes.clear();
+        deviceTable.clear();
+        alpha.clear();
+        alphaLookup.clear();
+        rules.clear();
+        sources.clear();
+    }
+
+    /**
+     * @brief Updates the sensor facts and propagates the change.
+     *
+     * Readings of local sensors (e.g., a modeled room's thermometer) only update
+     * their own sensor's fact; the kind-wide fact (`temp`) follows shared sensors.
+     *
+     * @param reading The published reading
+     */
+    void onSensorReading(const SensorReading& reading) override {
+        auto start = std::chrono::steady_clock::now();
+        if (reading.shared) setFact(static_cast<uint32_t>(reading.kind), reading.asFloat());
+        setFact(FIRST_SENSOR_SLOT + reading.sensor, reading.asFloat());
+        finishEvent(start);
+    }
+
+    /**
+     * @brief Updates the time-of-day fact and propagates the change.
+     * @param currentTime The current simulated time
+     */
+    void onTick(SimTime currentTime) {
+        auto start = std::chrono::steady_clock::now();
+        setFact(TIME_SLOT, timeOfDay(currentTime));
+        finishEvent(start);
+    }
+
+    /**
+     * @brief Re-tests the conditions on a device whose state changed.
+     * @param device The changed device
+     */
+    void update(SmartDevice* device) override {
+        auto start = std::chrono::steady_clock::now();
+        int id = device->getId();
+        if (id < static_cast<int>(deviceIndex.size())) {
+            for (uint32_t n : deviceIndex[id]) retest(n);
+        }
+        finishEvent(start);
+    }
+
+    /**
+     * @brief Returns the matching counters.
+     */
+    const Stats& getStats() const { return stats; }
+
+    /**
+     * @brief Returns the number of compiled rules.
+     */
+    size_t size() const { return rules.size(); }
+
+    /**
+     * @brief Lists the rules (up to a limit) and the matching cost per event.
+     */
+    void printRules() const {
+        std::cout << "\n=== Automation Rules (" << rules.size() << " rules, "
+                  << alpha.size() << " shared conditions) ===\n";
+        for (size_t i = 0; i < sources.size() && i < 20; ++i) {
+            std::cout << "  " << i + 1 << ". " << sources[i]
+                      << (rules[i].satisfied == rules[i].needed ? " [satisfied]" : "") << "\n";
+        }
+        if (sources.size() > 20) std::cout << "  ... " << sources.size() - 20 << " more\n";
+        std::cout << "Events: " << stats.events << ", conditions re-tested: " << stats.alphaTests
+                  << ", rule updates: " << stats.ruleUpdates << ", firings: " << stats.firings << "\n";
+        if (stats.events > 0) {
+            std::cout << "Cost per event: " << stats.nanoseconds / stats.events << " ns\n";
+        }
+        std::cout << "===========================\n";
+    }
+
+private:
+    /**
+     * @brief Returns the alpha node for a condition, creating and indexing it if new.
+     */
+    uint32_t alphaNode(const Instruction& in) {
+        auto it = alphaLookup.find(in);
+        if (it != alphaLookup.end()) return it->second;
+
+        uint32_t n = static_cast<uint32_t>(alpha.size());
+        alpha.push_back(AlphaNode{in, test(in), {}});
+        alphaLookup.emplace(in, n);
+
+        if (in.op == Op::DeviceOn || in.op == Op::DeviceOff) {
+            int id = deviceTable[in.slot]->getId();
+            if (id >= static_cast<int>(deviceIndex.size())) {
+                deviceIndex.resize(id + 1);
+                observedDevices.resize(id + 1, false);
+            }
+            deviceIndex[id].push_back(n);
+            if (!observedDevices[id]) {
+                SubscriptionTable::instance().subscribe(id, this);
+                observedDevices[id] = true;
+            }
+            return n;
+        }
+
+        if (in.slot >= factIndex.size()) factIndex.resize(in.slot + 1);
+        FactIndex& index = factIndex[in.slot];
+        switch (in.op) {
+            case Op::Eq: case Op::Ne: index.equality.push_back({in.a, n}); break;
+            case Op::InRange: case Op::OutRange: index.windows.push_back(n); return n;
+            default: index.ordered.push_back({in.a, n}); break;
+        }
+        index.sorted = false;
+        return n;
+    }
+
+    /**
+     * @brief Stores a fact value and re-tests only the conditions it can flip.
+     */
+    void setFact(uint32_t slot, float value) {
+        if (slot >= facts.size()) facts.resize(slot + 1, UNSEEN);
+        float old = facts[slot];
+        if (old == value || (std::isnan(old) && std::isnan(value))) return;
+        facts[slot] = value;
+        if (slot >= factIndex.size()) return;
+
+        FactIndex& index = factIndex[slot];
+        if (std::isnan(old) || std::isnan(value)) {
+            // Gaining or losing a value can flip any condition on the fact
+            for (const auto& e : index.ordered) retest(e.second);
+            for (const auto& e : index.equality) retest(e.second);
+            for (uint32_t n : index.windows) retest(n);
+            return;
+        }
+        if (!index.sorted) {
+            std::sort(index.ordered.begin(), index.ordered.end());
+            std::sort(index.equality.begin(), index.equality.end());
+            index.sorted = true;
+        }
+
+        // A comparison against c can only flip if c lies between the old and new value
+        auto byConstant = [](const std::pair<float, uint32_t>& e, float v) { return e.first < v; };
+        auto it = std::lower_bound(index.ordered.begin(), index.ordered.end(), std::min(old, value), byConstant);
+        float hi = std::max(old, value);
+        for (; it != index.ordered.end() && it->first <= hi; ++it) retest(it->second);
+
+        for (float v : {old, value}) {
+            auto eq = std::lower_bound(index.equality.begin(), index.equality.end(), v, byConstant);
+            for (; eq != index.equality.end() && eq->first == v; ++eq) retest(eq->second);
+        }
+        for (uint32_t n : index.windows) retest(n);
+    }
+
+    /**
+     * @brief Re-tests one alpha node and records it if its truth value flipped.
+     */
+    void retest(uint32_t n) {
+        AlphaNode& node = alpha[n];
+        stats.alphaTests++;
+        bool now = test(node.cond);
+        if (now == node.truth) return;
+        node.truth = now;
+        (now ? rises : falls).push_back(n);
+    }
+
+    /**
+     * @brief Propagates the flipped nodes of one event to their rules and applies actions.
+     *
+     * Falling conditions are applied before rising ones, so a rule whose conditions
+     * change in both directions within the same event never fires spuriously.
+     */
+    void finishEvent(std::chrono::steady_clock::time_point start) {
+        for (uint32_t n : falls) {
+            for (uint32_t r : alpha[n].rules) rules[r].satisfied--;
+            stats.ruleUpdates += static_cast<long long>(alpha[n].rules.size());
+        }
+        for (uint32_t n : rises) {
+            for (uint32_t r : alpha[n].rules) {
+                CompiledRule& rule = rules[r];
+                if (++rule.satisfied == rule.needed) {
+                    actions.push_back({rule.target, rule.turnOn});
+                    stats.firings++;
+                }
+            }
+            stats.ruleUpdates += static_cast<long long>(alpha[n].rules.size());
+        }
+        rises.clear();
+        falls.clear();
+        stats.events++;
+        stats.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        applyActions();
+    }
+
+    /**
+     * @brief Tests a single condition against the current facts.
+     */
+    bool test(const Instruction& in) const {
+        switch (in.op) {
+            case Op::Gt: return facts[in.slot] > in.a;
+            case Op::Ge: return facts[in.slot] >= in.a;
+            case Op::Lt: return facts[in.slot] < in.a;
+            case Op::Le: return facts[in.slot] <= in.a;
+            case Op::Eq: return facts[in.slot] == in.a;
+            case Op::Ne: return !std::isnan(facts[in.slot]) && facts[in.slot] != in.a;
+            case Op::InRange: return facts[in.slot] >= in.a && facts[in.slot] < in.b;
+            case Op::OutRange: return facts[in.slot] >= in.a || facts[in.slot] < in.b;
+            case Op::DeviceOn: return deviceTable[in.slot]->getState();
+            case Op::DeviceOff: return !deviceTable[in.slot]->getState();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Applies pending actions; setState only notifies on real changes.
+     *
+     * Without a notification batch, a state change reaches update() synchronously
+     * and may fire further rules; such cascades are cut off at MAX_CASCADE levels.
+     */
+    void applyActions() {
+        if (actions.empty()) return;
+        if (cascadeDepth >= MAX_CASCADE) {
+            std::cout << "[Rules] Cascade limit reached; " << actions.size() << " actions dropped.\n";
+            actions.clear();
+            return;
+        }
+        std::vector<std::pair<SmartDevice*, bool>> pending;
+        pending.swap(actions);
+        cascadeDepth++;
+        for (auto& [device, on] : pending) device->setState(on);
+        cascadeDepth--;
+    }
+
+
+    /**
+     * @brief Parses a rule into instructions, resolving every name to a slot.
+     */
+    bool compile(const std::string& text, std::vector<Instruction>& out, CompiledRule& rule, std::string& error) {
+        std::string body = trim(text);
+        if (lower(body.substr(0, 3)) != "if ") {
+            error = "Rule must start with \"if\".";
+            return false;
+        }
+        size_t thenPos = findWord(body, "then");
+        if (thenPos == std::string::npos) {
+            error = "Missing \"then\".";
+            return false;
+        }
+
+        // Action: <device name> ON|OFF
+        std::string action = trim(body.substr(thenPos + 4));
+        size_t lastSpace = action.find_last_of(' ');
+        std::string stateWord = lower(lastSpace == std::string::npos ? action : action.substr(lastSpace + 1));
+        if (lastSpace == std::string::npos || (stateWord != "on" && stateWord != "off")) {
+            error = "Action must be \"<device> ON\" or \"<device> OFF\".";
+            return false;
+        }
+        rule.target = controller.findDevice(trim(action.substr(0, lastSpace)));
+        rule.turnOn = stateWord == "on";
+        if (!rule.target) {
+            error = "Unknown device \"" + trim(action.substr(0, lastSpace)) + "\".";
+            return false;
+        }
+
+        // Conditions separated by "and"
+        std::string conditions = body.substr(3, thenPos - 3);
+        size_t start = 0;
+        while (true) {
+            size_t andPos = findWord(conditions, "and", start);
+            std::string cond = trim(conditions.substr(start, andPos == std::string::npos ? std::string::npos : andPos - start));
+            if (!compileCondition(cond, out, error)) return false;
+            if (andPos == std::string::npos) break;
+            start = andPos + 3;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Compiles one condition into an instruction.
+     */
+    bool compileCondition(const std::string& cond, std::vector<Instruction>& out, std::string& error) {
+        if (cond.empty()) {
+            error = "Empty condition.";
+            return false;
+        }
+
+        // time between HH:MM-HH:MM
+        if (lower(cond.substr(0, 13)) == "time between ") {
+            std::string range = cond.substr(13);
+            size_t dash = range.find('-');
+            size_t dashLen = 1;
+            if (dash == std::string::npos) {
+                dash = range.find("\xE2\x80\x93");  // en dash
+                dashLen = 3;
+            }
+            int from, to;
+            if (dash == std::string::npos || !parseClock(trim(range.substr(0, dash)), from)
+                || !parseClock(trim(range.substr(dash + dashLen)), to)) {
+                error = "Time window must look like 22:00-06:00.";
+                return false;
+            }
+            Op op = from <= to ? Op::InRange : Op::OutRange;
+            out.push_back(Instruction{op, TIME_SLOT, static_cast<float>(from), static_cast<float>(to)});
+            return true;
+        }
+
+        // <device name> is ON|OFF
+        size_t isPos = findWord(cond, "is");
+        if (isPos != std::string::npos) {
+            SmartDevice* d = controller.findDevice(trim(cond.substr(0, isPos)));
+            std::string state = lower(trim(cond.substr(isPos + 2)));
+            if (!d || (state != "on" && state != "off")) {
+                error = "Unknown device condition \"" + cond + "\".";
+                return false;
+            }
+            uint32_t slot = static_cast<uint32_t>(std::find(deviceTable.begin(), deviceTable.end(), d) - deviceTable.begin());
+            if (slot == deviceTable.size()) deviceTable.push_back(d);
+            out.push_back(Instruction{state == "on" ? Op::DeviceOn : Op::DeviceOff, slot, 0.0f, 0.0f});
+            return true;
+        }
+
+        // <sensor-id | kind> <op> <number>
+        std::istringstream in(cond);
+        std::string source, opText, valueText, extra;
+        in >> source >> opText >> valueText;
+        Op op;
+        float value;
+        if (!parseOp(opText, op) || !parseNumber(valueText, value) || (in >> extra)) {
+            error = "Cannot parse condition \"" + cond + "\".";
+            return false;
+        }
+        SensorKind kind;
+        uint32_t slot;
+        if (parseSensorKind(lower(source), kind)) {
+            slot = static_cast<uint32_t>(kind);
+        } else if (Sensor* s = sensors.find(source)) {
+            slot = FIRST_SENSOR_SLOT + static_cast<uint32_t>(s->getHandle());
+            if (slot >= facts.size()) facts.resize(slot + 1, UNSEEN);
+            if (s->hasValue()) facts[slot] = s->lastReading().asFloat();
+        } else {
+            error = "Unknown sensor or kind \"" + source + "\".";
+            return false;
+        }
+        out.push_back(Instruction{op, slot, value, 0.0f});
+        return true;
+    }
+
+    static bool parseOp(const std::string& text, Op& op) {
+        if (text == ">") op = Op::Gt;
+        else if (text == ">=") op = Op::Ge;
+        else if (text == "<") op = Op::Lt;
+        else if (text == "<=") op = Op::Le;
+        else if (text == "==" || text == "=") op = Op::Eq;
+        else if (text == "!=") op = Op::Ne;
+        else return false;
+        return true;
+    }
+
+    static bool parseNumber(const std::string& text, float& value) {
+        try {
+            size_t used;
+            value = std::stof(text, &used);
+            return used == text.size();
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    static bool parseClock(const std::string& text, int& seconds) {
+        int h, m;
+        char colon;
+        std::istringstream in(text);
+        if (!(in >> h >> colon >> m) || colon != ':' || h < 0 || h > 24 || m < 0 || m > 59) return false;
+        if (h == 24 && m != 0) return false;  // 24:00 is the only time past 23:59
+        seconds = (h * 60 + m) * 60;
+        return true;
+    }
+
+    static float timeOfDay(SimTime time) {
+        int64_t seconds = SimClock::wholeSeconds(time);
+        return static_cast<float>(((seconds % 86400) + 86400) % 86400);
+    }
+
+    static std::string trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t");
+        if (b == std::string::npos) return "";
+        return s.substr(b, s.find_last_not_of(" \t") - b + 1);
+    }
+
+    static std::string lower(std::string s) {
+        for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return s;
+    }
+
+    /**
+     * @brief Finds a whole word (case-insensitive) surrounded by spaces.
+     */
+    static size_t findWord(const std::string& s, const std::string& word, size_t from = 0) {
+        std::string ls = lower(s);
+        std::string needle = " " + word + " ";
+        size_t pos = (" " + ls + " ").find(needle, from);
+        return pos == std::string::npos ? std::string::npos : pos;
+    }
+};
+
+#endif // RULE_ENGINE_H
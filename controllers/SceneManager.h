@@ -0,0 +1,141 @@
+/**
+ * @file SceneManager.h
+ * @brief Named scenes (Night, Away, Movie, ...) that set many devices at once.
+ *
+ * A scene is a target-state vector stored as two `DeviceSet`s: `mask` holds the
+ * devices the scene controls and `on` the ones it wants switched on. Activating
+ * a scene computes the devices that differ from the target with word-wise
+ * operations against the global on-state bitset:
+ *
+ *     changed = (onDevices XOR scene.on) AND scene.mask
+ *
+ * Only those devices are set, inside one notification batch, so observers see a
+ * single delivery and devices already in the target state are left alone (unlike
+ * toggling, which would flip them).
+ *
+ * Responsibilities:
+ * - Capture the current state of a zone as a scene
+ * - Edit the target state of single devices in a scene
+ * - Activate scenes by applying only the difference from the current state
+ */
+
+#ifndef SCENE_MANAGER_H
+#define SCENE_MANAGER_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DeviceController.h"
+#include "../models/SmartDevice.h"
+#include "../utils/DeviceSet.h"
+
+class SceneManager {
+public:
+    /**
+     * @brief One named target state.
+     */
+    struct Scene {
+        std::string name;
+        DeviceSet mask;   ///< Devices controlled by the scene
+        DeviceSet on;     ///< Devices the scene switches on (subset of mask)
+    };
+
+    /**
+     * @brief Outcome of an activation.
+     */
+    struct Activation {
+        int changed = 0;          ///< Devices whose state was changed
+        double microseconds = 0;  ///< Time spent computing and applying the difference
+    };
+
+private:
+    DeviceController& controller;
+    std::vector<Scene> scenes;
+
+public:
+    /**
+     * @brief Constructs an empty scene list.
+     * @param devices Controller used to resolve device handles
+     */
+    explicit SceneManager(DeviceController& devices) : controller(devices) {}
+
+    /**
+     * @brief Saves the current state of a set of devices as a scene, replacing any scene of that name.
+     * @param name Scene name
+     * @param devices Devices the scene controls (e.g., a zone's members)
+     */
+    void capture(const std::string& name, const DeviceSet& devices) {
+        Scene& scene = getOrCreate(name);
+        scene.mask = devices;
+        scene.on = devices;
+        scene.on &= SmartDevice::getOnDevices();
+    }
+
+    /**
+     * @brief Sets the target state of one device in a scene, creating the scene if needed.
+     */
+    void setTarget(const std::string& name, const SmartDevice* device, bool on) {
+        Scene& scene = getOrCreate(name);
+        scene.mask.set(device->getId());
+        scene.on.assign(device->getId(), on);
+    }
+
+    /**
+     * @brief Returns a scene by name, or nullptr.
+     */
+    const Scene* find(const std::string& name) const {
+        for (const auto& s : scenes) {
+            if (s.name == name) return &s;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Applies a scene, changing only devices not already in their target state.
+     * @param scene The scene to activate
+     * @return Number of changed devices and the time taken
+     */
+    Activation activate(const Scene& scene) {
+        auto start = std::chrono::steady_clock::now();
+        DeviceSet changed = SmartDevice::getOnDevices();
+        changed ^= scene.on;
+        changed &= scene.mask;
+
+        Activation result;
+        SmartDevice::beginNotificationBatch();
+        changed.forEach([&](int id) {
+            if (SmartDevice* d = controller.getDeviceById(id)) {
+                d->setState(scene.on.test(id));
+                result.changed++;
+            }
+        });
+        SmartDevice::endNotificationBatch();
+        result.microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    /**
+     * @brief Lists the scenes with how many devices each controls and switches on.
+     */
+    void printScenes() const {
+        std::cout << "\n=== Scenes ===\n";
+        if (scenes.empty()) std::cout << "No scenes defined.\n";
+        for (const auto& s : scenes) {
+            std::cout << "- " << s.name << ": " << s.mask.count() << " devices ("
+                      << s.on.count() << " on, " << s.mask.count() - s.on.count() << " off)\n";
+        }
+        std::cout << "==============\n";
+    }
+
+private:
+    Scene& getOrCreate(const std::string& name) {
+        for (auto& s : scenes) {
+            if (s.name == name) return s;
+        }
+        scenes.push_back(Scene{name, {}, {}});
+        return scenes.back();
+    }
+};
+
+#endif // SCENE_MANAGER_H
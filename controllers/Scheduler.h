@@ -11,9 +11,13 @@
  *
  * Responsibilities:
  * - Store scheduled tasks for devices
- * - Evaluate tasks on each simulation tick
+ * - Keep tasks in a min-heap ordered by their next due time (from nextFireTime()),
+ *   so a tick only looks at tasks that are actually due
  * - Trigger device state changes when appropriate
- * - Clean up dynamically allocated strategies
+ * - Hand out task IDs and cancel tasks in O(1)
+ * - Reclaim completed and cancelled task slots (and their strategies) through a free list
+ * - Detect conflicting and redundant tasks per device when they are added
+ * - Merge actions due at the same instant on the same device into one transition
  *
  * Dependencies:
  * - SmartDevice.h: Abstract base class for all devices
@@ -27,8 +31,14 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
 #include "../models/SmartDevice.h"
 #include "../models/strategies/scheduling/SchedulingStrategy.h"
+#include "../utils/SimClock.h"
+#include "../utils/TimelineIndex.h"
 
 /**
  * @brief Represents a task to change a device's state at a scheduled time.
@@ -37,12 +47,17 @@
  * - the target device's name
  * - whether it should be turned ON or OFF
  * - the scheduling strategy that determines when to execute
+ *
+ * Tasks live in reusable slots; a slot whose strategy is nullptr is free.
  */
 struct ScheduledTask {
-    std::string deviceName;                  ///< Name of the target device
+    std::string deviceName;                  ///< Name of the target device (kept until it resolves)
+    SmartDevice* device = nullptr;           ///< Resolved target device
     bool turnOn;                             ///< Desired state (true = ON, false = OFF)
     SchedulingStrategy* strategy;            ///< Strategy determining when task should trigger
-    bool completed = false;                  ///< Flag to determine if the task is done
+    uint32_t generation = 0;                 ///< Incremented each time the slot is freed
+    SimTime due = SchedulingStrategy::NEVER; ///< Time the task is queued for
+    uint64_t sequence = 0;                   ///< Order in which the task was added (later wins)
 };
 
 /**
@@ -50,12 +65,123 @@ struct ScheduledTask {
  *
  * The Scheduler keeps track of all scheduled tasks and triggers device actions
  * by delegating the time-check logic to the strategy associated with each task.
+ *
+ * A task ID packs the task's slot with the slot's generation, so an ID stays
+ * invalid after its task completed or was cancelled even when the slot is reused.
+ * Cancelling frees the slot at once; the task's heap entry is left behind and
+ * skipped when it surfaces (lazy deletion), and the heap is compacted when such
+ * stale entries make up most of it.
+ *
+ * Conflicts are found through a timeline: a flat hash index from (device,
+ * instant) to the chain of tasks firing then, newest first, filled with each
+ * task's fire times within the day after it is added. A new task looks up each
+ * of its fire times there; two tasks firing at the same instant conflict
+ * (opposite states) or are redundant (same state), and the ConflictPolicy
+ * decides which one stays. Entries of released tasks and past instants are
+ * dropped lazily. Whatever remains, all actions due at one instant for one
+ * device are applied as a single transition to the state of the most recently
+ * added task.
  */
 class Scheduler {
+public:
+    using TaskId = uint64_t;
+    static constexpr TaskId INVALID_TASK = ~TaskId(0);
+
+    /**
+     * @brief What to do when a new task fires at the same instant as another task of its device.
+     */
+    enum class ConflictPolicy {
+        Warn,       ///< Keep both; the later task's state wins at fire time
+        KeepFirst,  ///< Reject the task added later
+        KeepLast    ///< Cancel the task added earlier
+    };
+
+    /**
+     * @brief A detected pair of tasks firing on one device at the same instant.
+     */
+    struct Conflict {
+        SimTime time;       ///< Instant at which both tasks fire
+        const SmartDevice* device;
+        TaskId earlier;     ///< Task added first
+        TaskId later;       ///< Task added second
+        bool redundant;     ///< Both tasks set the same state
+    };
+
+    /**
+     * @brief Cumulative conflict and merge counters.
+     */
+    struct ConflictStats {
+        uint64_t conflicts = 0;  ///< Pairs setting opposite states
+        uint64_t redundant = 0;  ///< Pairs setting the same state
+        uint64_t resolved = 0;   ///< Tasks rejected or cancelled by the policy
+        uint64_t merged = 0;     ///< Same-instant actions folded into another at fire time
+    };
+
+    /**
+     * @brief A task prepared for bulk insertion with addTasks().
+     */
+    struct NewTask {
+        SmartDevice* device;
+        bool turnOn;
+        SchedulingStrategy* strategy;
+        SimTime due;                 ///< strategy->nextFireTime(now), computed by the caller
+    };
+
 private:
-    std::vector<ScheduledTask> tasks;               ///< List of all active scheduled tasks
+    /**
+     * @brief Heap entry; stale once the slot's generation moved on.
+     */
+    struct QueueEntry {
+        SimTime due;
+        uint32_t slot;
+        uint32_t generation;
+
+        bool operator>(const QueueEntry& o) const {
+            return due != o.due ? due > o.due : slot > o.slot;
+        }
+    };
+
+    std::vector<ScheduledTask> tasks;               ///< Task slots (live and free)
+    std::vector<uint32_t> freeSlots;                ///< Free list of reusable slots
+    std::vector<QueueEntry> queue;                  ///< Min-heap of due times
+    size_t staleEntries = 0;                        ///< Heap entries of cancelled tasks
     std::vector<SmartDevice*>* devices;             ///< Pointer to the global device list
 
+    /**
+     * @brief A task firing at one instant; `below` links to the task added before it.
+     */
+    struct TimelineEntry {
+        TaskId task;
+        uint32_t below;
+    };
+
+    static constexpr uint32_t NO_ENTRY = TimelineIndex::NO_ENTRY;
+
+    TimelineIndex timeline;                         ///< (device, instant) -> newest entry
+    std::vector<TimelineEntry> timelineEntries;     ///< Entry pool, linked into chains
+    std::vector<uint32_t> freeEntries;              ///< Free list of the entry pool
+    size_t timelinePruneAt = 1024;                  ///< Index size that triggers dropping past instants
+    SimTime timelinePrunedAt = 0;                   ///< Time of the last prune (nothing older is left)
+    uint64_t nextSequence = 0;                      ///< Sequence number of the next added task
+    ConflictPolicy policy = ConflictPolicy::Warn;
+    ConflictStats stats;
+    std::deque<Conflict> recentConflicts;           ///< Most recent detections, for reporting
+
+    /**
+     * @brief A triggered action waiting to be applied at the current instant.
+     */
+    struct Action {
+        SmartDevice* device;
+        bool turnOn;
+        uint64_t sequence;
+    };
+
+    std::vector<Action> firing;                     ///< Scratch buffer for same-instant merging
+
+    static constexpr SimTime CONFLICT_HORIZON = SimClock::DAY; ///< Look-ahead window of conflict detection
+    static constexpr int CONFLICT_OCCURRENCES = 16; ///< Fire times indexed per task in the window
+    static constexpr size_t RECENT_CONFLICTS = 20;  ///< Detections kept for printConflicts()
+
 public:
     /**
      * @brief Constructs the Scheduler.
@@ -63,48 +189,435 @@ public:
      */
     Scheduler(std::vector<SmartDevice*>* allDevices) : devices(allDevices) {}
 
+    /**
+     * @brief Frees the strategies of all live tasks.
+     */
+    ~Scheduler() {
+        for (auto& task : tasks) delete task.strategy;
+    }
+
     /**
      * @brief Adds a new scheduled task with a specific strategy.
      * @param name Name of the target device
      * @param turnOn Whether to turn the device on (true) or off (false)
-     * @param strategy Pointer to the scheduling strategy
+     * @param strategy Pointer to the scheduling strategy (owned by the Scheduler)
+     * @return ID for cancel(), or INVALID_TASK if the strategy never fires (it is deleted)
+     *         or the conflict policy rejected the task
+     */
+    TaskId addTask(const std::string& name, bool turnOn, SchedulingStrategy* strategy) {
+        SmartDevice* device = findDeviceByName(name);
+        return insertTask(device, device ? std::string() : name, turnOn, strategy);
+    }
+
+    /**
+     * @brief Adds a new scheduled task for an already resolved device (no name lookup).
+     * @param device Target device
+     * @param turnOn Whether to turn the device on (true) or off (false)
+     * @param strategy Pointer to the scheduling strategy (owned by the Scheduler)
+     * @return ID for cancel(), or INVALID_TASK as for addTask(name, ...)
+     */
+    TaskId addTask(SmartDevice* device, bool turnOn, SchedulingStrategy* strategy) {
+        return insertTask(device, std::string(), turnOn, strategy);
+    }
+
+private:
+    /**
+     * @brief Fills a slot for a task on `device`, or on the unresolved device `name`.
+     */
+    TaskId insertTask(SmartDevice* device, const std::string& name, bool turnOn, SchedulingStrategy* strategy) {
+        SimTime due = strategy->nextFireTime(SimClock::now());
+        if (due == SchedulingStrategy::NEVER) {
+            delete strategy;
+            return INVALID_TASK;
+        }
+
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(tasks.size());
+            tasks.emplace_back();
+        }
+        ScheduledTask& task = tasks[slot];
+        task.device = device;
+        task.deviceName = name;
+        task.turnOn = turnOn;
+        task.strategy = strategy;
+        task.sequence = nextSequence++;
+        enqueue(slot, due);
+        TaskId id = taskId(slot);
+        if (task.device && !indexTask(slot, true)) id = INVALID_TASK;
+        if (staleEntries > 64 && staleEntries * 2 > queue.size()) compact();
+        return id;
+    }
+
+public:
+    /**
+     * @brief Inserts many tasks at once with a single heap build.
+     *
+     * Slots are filled first and the heap is rebuilt with one make_heap (linear
+     * time) instead of one push per task. Tasks whose due time is NEVER are
+     * dropped and their strategies deleted. Conflicts are detected and resolved
+     * as for addTask() in batch order, but counted rather than printed.
+     *
+     * @param batch Tasks with resolved devices and precomputed due times
+     * @return Number of tasks inserted (after the conflict policy)
+     */
+    size_t addTasks(const std::vector<NewTask>& batch) {
+        tasks.reserve(tasks.size() + batch.size());
+        queue.reserve(queue.size() + batch.size());
+        timeline.reserve(timeline.size() + batch.size());
+        size_t before = liveTasks();
+        for (const NewTask& t : batch) {
+            if (t.due == SchedulingStrategy::NEVER) {
+                delete t.strategy;
+                continue;
+            }
+            uint32_t slot;
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            } else {
+                slot = static_cast<uint32_t>(tasks.size());
+                tasks.emplace_back();
+            }
+            ScheduledTask& task = tasks[slot];
+            task.device = t.device;
+            task.turnOn = t.turnOn;
+            task.strategy = t.strategy;
+            task.due = t.due;
+            task.sequence = nextSequence++;
+            queue.push_back(QueueEntry{t.due, slot, task.generation});
+            indexTask(slot, false);
+        }
+        std::make_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        if (staleEntries > 64 && staleEntries * 2 > queue.size()) compact();
+        return liveTasks() - before;
+    }
+
+    /**
+     * @brief Cancels a scheduled task.
+     * @param id ID returned by addTask()
+     * @return false if the task already completed, was cancelled or never existed
+     */
+    bool cancel(TaskId id) {
+        uint32_t slot = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        if (slot >= tasks.size()) return false;
+        ScheduledTask& task = tasks[slot];
+        if (!task.strategy || task.generation != static_cast<uint32_t>(id >> 32)) return false;
+        release(slot);
+        staleEntries++;
+        if (staleEntries > 64 && staleEntries * 2 > queue.size()) compact();
+        return true;
+    }
+
+    /**
+     * @brief Selects how future conflicts are resolved.
+     */
+    void setConflictPolicy(ConflictPolicy p) { policy = p; }
+
+    /**
+     * @brief Returns the current conflict policy.
+     */
+    ConflictPolicy getConflictPolicy() const { return policy; }
+
+    /**
+     * @brief Parses "warn", "keep-first" or "keep-last".
+     * @return false if the name is unknown
+     */
+    static bool parsePolicy(const std::string& name, ConflictPolicy& out) {
+        if (name == "warn") out = ConflictPolicy::Warn;
+        else if (name == "keep-first") out = ConflictPolicy::KeepFirst;
+        else if (name == "keep-last") out = ConflictPolicy::KeepLast;
+        else return false;
+        return true;
+    }
+
+    /**
+     * @brief Returns the name of a conflict policy.
+     */
+    static const char* policyName(ConflictPolicy p) {
+        switch (p) {
+            case ConflictPolicy::KeepFirst: return "keep-first";
+            case ConflictPolicy::KeepLast: return "keep-last";
+            default: return "warn";
+        }
+    }
+
+    /**
+     * @brief Returns the cumulative conflict and merge counters.
      */
-    void addTask(const std::string& name, bool turnOn, SchedulingStrategy* strategy) {
-        tasks.push_back(ScheduledTask{name, turnOn, strategy});
+    const ConflictStats& getConflictStats() const { return stats; }
+
+    /**
+     * @brief Prints the policy, the counters and the most recent detections.
+     */
+    void printConflicts() const {
+        std::cout << "\n=== Schedule Conflicts (policy: " << policyName(policy) << ") ===\n";
+        std::cout << stats.conflicts << " conflicting, " << stats.redundant << " redundant, "
+                  << stats.resolved << " resolved by policy, " << stats.merged << " actions merged at fire time\n";
+        for (const auto& c : recentConflicts) {
+            std::cout << "- t=" << SimClock::format(c.time) << " " << c.device->getName() << ": task " << c.earlier << " and task " << c.later
+                      << (c.redundant ? " (redundant)" : " (conflict)") << "\n";
+        }
+        std::cout << "===========================\n";
+    }
+
+    /**
+     * @brief Returns the number of live (pending or repeating) tasks.
+     */
+    size_t liveTasks() const { return tasks.size() - freeSlots.size(); }
+
+    /**
+     * @brief Returns the time the earliest task is due, or SchedulingStrategy::NEVER.
+     */
+    SimTime nextDue() {
+        while (!queue.empty() && isStale(queue.front())) popFront();
+        return queue.empty() ? SchedulingStrategy::NEVER : queue.front().due;
     }
 
     /**
      * @brief Clears all scheduled tasks and deletes associated strategies.
      *
-     * Called during reset to free memory and restart the schedule list.
+     * Called during reset to free memory and restart the schedule list. Slots are
+     * freed rather than dropped so IDs handed out earlier stay invalid.
      */
     void clearTasks() {
-        for (auto& task : tasks) {
-            delete task.strategy; // Free strategy memory
+        for (uint32_t slot = 0; slot < tasks.size(); ++slot) {
+            if (tasks[slot].strategy) release(slot);
         }
-        tasks.clear();
+        queue.clear();
+        staleEntries = 0;
         std::cout << "[Scheduler] All scheduled tasks cleared.\n";
     }
 
     /**
-     * @brief Called on each simulation tick to evaluate and trigger tasks.
-     * @param currentTime The current simulated time in seconds
+     * @brief Called on each simulation tick to trigger the tasks that are due.
+     *
+     * Only tasks at the top of the heap are examined, one due instant at a time
+     * and in time order. Each task is checked with shouldTrigger() at its due time
+     * and then either re-queued at its next fire time or, once done, released. The
+     * actions of one instant are then applied together in one notification batch:
+     * a device targeted by several of them changes state once, to the state of the
+     * most recently added task. Callers that need observers to see each instant's
+     * own timestamp step through nextDue() and call update() once per instant.
+     *
+     * @param currentTime The current simulated time
      */
-    void update(int currentTime) {
-        for (auto& task : tasks) {
-            if (!task.completed && task.strategy->shouldTrigger(currentTime)) {
-                SmartDevice* device = findDeviceByName(task.deviceName);
-                if (device) {
-                    device->setState(task.turnOn);
-                    std::cout << "[Scheduler] " << task.deviceName << " turned "
-                              << (task.turnOn ? "ON" : "OFF") << " at time " << currentTime << "s\n";
-                    task.completed = task.strategy->isDone();
+    void update(SimTime currentTime) {
+        while (!queue.empty() && queue.front().due <= currentTime) {
+            SimTime instant = queue.front().due;
+            firing.clear();
+            while (!queue.empty() && queue.front().due == instant) {
+                QueueEntry entry = queue.front();
+                popFront();
+                if (isStale(entry)) continue;
+
+                ScheduledTask& task = tasks[entry.slot];
+                bool done = false;
+                if (task.strategy->shouldTrigger(entry.due)) {
+                    if (!task.device) task.device = findDeviceByName(task.deviceName);
+                    if (task.device) {
+                        firing.push_back(Action{task.device, task.turnOn, task.sequence});
+                        done = task.strategy->isDone();
+                    }
                 }
+                SimTime next = done ? SchedulingStrategy::NEVER : task.strategy->nextFireTime(entry.due);
+                if (next == SchedulingStrategy::NEVER) release(entry.slot);
+                else enqueue(entry.slot, next);
             }
+            applyFiring(instant);
+        }
+    }
+
+    /**
+     * @brief Lists live tasks with their IDs and next due time.
+     */
+    void printTasks() const {
+        std::cout << "\n=== Scheduled Tasks (" << liveTasks() << " live, "
+                  << tasks.size() << " slots, " << queue.size() << " queued) ===\n";
+        for (uint32_t slot = 0; slot < tasks.size(); ++slot) {
+            const ScheduledTask& task = tasks[slot];
+            if (!task.strategy) continue;
+            std::cout << "- [" << taskId(slot) << "] "
+                      << (task.device ? task.device->getName() : task.deviceName) << " " << (task.turnOn ? "ON" : "OFF")
+                      << ", next at t=" << SimClock::format(task.due) << "\n";
         }
+        std::cout << "===========================\n";
     }
 
 private:
+    /**
+     * @brief Pushes a task onto the heap at its due time.
+     */
+    void enqueue(uint32_t slot, SimTime due) {
+        tasks[slot].due = due;
+        queue.push_back(QueueEntry{due, slot, tasks[slot].generation});
+        std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+    }
+
+    void popFront() {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        if (isStale(queue.back())) staleEntries--;
+        queue.pop_back();
+    }
+
+    bool isStale(const QueueEntry& e) const {
+        return tasks[e.slot].generation != e.generation;
+    }
+
+    /**
+     * @brief Frees a slot: deletes its strategy and invalidates its ID and heap entry.
+     */
+    void release(uint32_t slot) {
+        ScheduledTask& task = tasks[slot];
+        delete task.strategy;
+        task.strategy = nullptr;
+        task.deviceName.clear();
+        task.device = nullptr;
+        task.generation++;
+        freeSlots.push_back(slot);
+    }
+
+    TaskId taskId(uint32_t slot) const {
+        return (static_cast<TaskId>(tasks[slot].generation) << 32) | slot;
+    }
+
+    bool isLive(TaskId id) const {
+        uint32_t slot = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        return slot < tasks.size() && tasks[slot].strategy && tasks[slot].generation == static_cast<uint32_t>(id >> 32);
+    }
+
+    /**
+     * @brief Enters a new task's fire times in its device's timeline and applies the conflict policy.
+     *
+     * Each fire time within CONFLICT_HORIZON is looked up in the timeline; the
+     * latest live task already there is the one the new task would override. The
+     * pair is recorded once per task pair, and the policy removes one of the two.
+     *
+     * @param slot Slot of the new task (its device must be resolved)
+     * @param report Print each detection
+     * @return false if the policy rejected the new task
+     */
+    bool indexTask(uint32_t slot, bool report) {
+        ScheduledTask& task = tasks[slot];
+        SimTime now = SimClock::now();
+        if (timeline.size() >= timelinePruneAt && now > timelinePrunedAt) pruneTimeline(now);
+
+        TaskId id = taskId(slot);
+        TaskId lastReported = INVALID_TASK;
+        SimTime t = task.due;
+        for (int n = 0; n < CONFLICT_OCCURRENCES && t != SchedulingStrategy::NEVER && t <= now + CONFLICT_HORIZON; ++n) {
+            uint32_t& head = timeline.at(task.device->getId(), t);
+            while (head != NO_ENTRY && !isLive(timelineEntries[head].task)) {  // Drop released tasks
+                uint32_t dead = head;
+                head = timelineEntries[dead].below;
+                freeEntries.push_back(dead);
+            }
+            TaskId earlier = head == NO_ENTRY ? INVALID_TASK : timelineEntries[head].task;
+            if (earlier != INVALID_TASK && earlier != lastReported) {
+                lastReported = earlier;
+                const ScheduledTask& other = tasks[static_cast<uint32_t>(earlier)];
+                recordConflict(Conflict{t, task.device, earlier, id, other.turnOn == task.turnOn},
+                               other.turnOn, report);
+                if (policy == ConflictPolicy::KeepFirst) {
+                    dropByPolicy(slot);
+                    return false;
+                }
+                if (policy == ConflictPolicy::KeepLast) dropByPolicy(static_cast<uint32_t>(earlier));
+            }
+            uint32_t entry;
+            if (!freeEntries.empty()) {
+                entry = freeEntries.back();
+                freeEntries.pop_back();
+                timelineEntries[entry] = TimelineEntry{id, head};
+            } else {
+                entry = static_cast<uint32_t>(timelineEntries.size());
+                timelineEntries.push_back(TimelineEntry{id, head});
+            }
+            head = entry;
+            t = task.strategy->isRecurring() ? task.strategy->nextFireTime(t) : SchedulingStrategy::NEVER;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Drops the instants that already passed.
+     *
+     * Runs when the index doubled in size since the last prune and time has moved
+     * on since then (fire times are always in the future when they are indexed).
+     */
+    void pruneTimeline(SimTime now) {
+        timeline.removeIf([now](SimTime instant) { return instant < now; },
+                          [this](uint32_t head) {
+                              for (uint32_t e = head; e != NO_ENTRY; e = timelineEntries[e].below) freeEntries.push_back(e);
+                          });
+        timelinePruneAt = std::max<size_t>(1024, timeline.size() * 2);
+        timelinePrunedAt = now;
+    }
+
+    /**
+     * @brief Counts, remembers and optionally prints one detected pair.
+     */
+    void recordConflict(const Conflict& c, bool earlierOn, bool report) {
+        (c.redundant ? stats.redundant : stats.conflicts)++;
+        if (report) {
+            std::cout << "[Scheduler] " << (c.redundant ? "Redundant" : "Conflicting") << " task " << c.later
+                      << ": " << c.device->getName() << " is also set " << (earlierOn ? "ON" : "OFF")
+                      << " at t=" << SimClock::format(c.time) << " by task " << c.earlier;
+            if (policy == ConflictPolicy::KeepFirst) std::cout << "; keeping task " << c.earlier;
+            else if (policy == ConflictPolicy::KeepLast) std::cout << "; cancelling task " << c.earlier;
+            std::cout << "\n";
+        }
+        recentConflicts.push_back(c);
+        if (recentConflicts.size() > RECENT_CONFLICTS) recentConflicts.pop_front();
+    }
+
+    /**
+     * @brief Removes a task on behalf of the conflict policy; its heap entry becomes stale.
+     */
+    void dropByPolicy(uint32_t slot) {
+        release(slot);
+        staleEntries++;
+        stats.resolved++;
+    }
+
+    /**
+     * @brief Applies the actions of one instant as one batch, one transition per device.
+     */
+    void applyFiring(SimTime instant) {
+        std::sort(firing.begin(), firing.end(), [](const Action& a, const Action& b) {
+            return a.device->getId() != b.device->getId() ? a.device->getId() < b.device->getId()
+                                                          : a.sequence < b.sequence;
+        });
+        SmartDevice::beginNotificationBatch();
+        for (size_t i = 0; i < firing.size();) {
+            size_t end = i + 1;
+            while (end < firing.size() && firing[end].device == firing[i].device) ++end;
+            const Action& last = firing[end - 1];
+            last.device->setState(last.turnOn);
+            std::cout << "[Scheduler] " << last.device->getName() << " turned "
+                      << (last.turnOn ? "ON" : "OFF") << " at time " << SimClock::format(instant);
+            if (end - i > 1) std::cout << " (merged " << end - i << " actions)";
+            std::cout << "\n";
+            stats.merged += end - i - 1;
+            i = end;
+        }
+        SmartDevice::endNotificationBatch();
+    }
+
+    /**
+     * @brief Drops stale entries and re-heapifies.
+     */
+    void compact() {
+        queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                   [this](const QueueEntry& e) { return isStale(e); }),
+                    queue.end());
+        std::make_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        staleEntries = 0;
+    }
+
     /**
      * @brief Finds a device by name from the device list.
      * @param name The name of the device to locate
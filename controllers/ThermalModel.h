@@ -0,0 +1,402 @@
+/**
+ * @file ThermalModel.h
+ * @brief Vectorized per-room temperature model that drives the room temperature sensors.
+ *
+ * The `ThermalModel` class simulates the air temperature of every modeled room
+ * and publishes it through that room's temperature sensor once per simulated
+ * second. Each room loses or gains heat through its envelope towards the
+ * outdoor temperature, a running Fan ventilates it (coupling it more strongly
+ * to outdoor air, in proportion to the fan's speed) and a running Thermostat
+ * heats or cools it with the output of its PID controller. Per second and room:
+ *
+ *     T += dt * ((kOut + kFan) * (Tout - T) + heat)
+ *
+ * with `heat` the sum of the room's thermostat outputs times their full power.
+ * The thermostats' controllers live in `Thermostat::getControllers()`: every
+ * step enables those of running thermostats, steps all of them in one batch
+ * pass against the room temperatures, and adds their outputs to their rooms.
+ *
+ * Room state is kept as structure-of-arrays in padded, 32-byte aligned arrays
+ * and integrated by an AVX2 or SSE2 kernel selected at runtime, with a portable
+ * scalar fallback (the same scheme as `ThresholdEvaluator`). An update first
+ * gathers the actuators' current state into the per-room arrays, then per step
+ * runs the PID pass and the room kernel, then publishes every room's sensor;
+ * readings inside the sensors' deadband are stored without fan-out.
+ *
+ * The loop is closed through the sensor subsystem: the model subscribes to its
+ * room sensors, and a published reading is compared with the threshold of every
+ * Fan and Thermostat in that room. Devices whose above/below state flipped get
+ * `onThresholdCrossed()`, exactly as for the whole-home sensor, and their new
+ * state is picked up by the next step.
+ *
+ * Responsibilities:
+ * - Keep per-room temperature and coupling in aligned arrays
+ * - Step all rooms with the best available SIMD kernel
+ * - Track which Fans and Thermostats are in which modeled room
+ * - Publish room temperatures and notify the room's devices of threshold crossings
+ *
+ * Design Pattern:
+ * - Observer Pattern: publishes through `Sensor`s and listens to them as a
+ *   `SensorListener`.
+ */
+
+#ifndef THERMAL_MODEL_H
+#define THERMAL_MODEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "../models/Fan.h"
+#include "../models/SmartDevice.h"
+#include "../models/Thermostat.h"
+#include "../models/sensor/Sensor.h"
+#include "../models/sensor/SensorListener.h"
+#include "../utils/AlignedAllocator.h"
+#include "../utils/SimClock.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SMARTHOME_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace thermal_kernels {
+
+/**
+ * @brief Per-room arrays of one integration step; all have `count` entries, a multiple of 8.
+ */
+struct Rooms {
+    float* temp;         ///< Air temperature (updated in place)
+    const float* kOut;   ///< Envelope coupling to outdoor air, per hour
+    const float* kFan;   ///< Extra coupling from running fans, per hour
+    const float* heat;   ///< Heating (positive) or cooling from thermostats, degrees per hour
+    size_t count;
+};
+
+using Kernel = void (*)(const Rooms& rooms, float outdoor, float dt);
+
+/**
+ * @brief Portable kernel: one room at a time.
+ */
+inline void stepScalar(const Rooms& r, float outdoor, float dt) {
+    for (size_t i = 0; i < r.count; ++i) {
+        float t = r.temp[i];
+        r.temp[i] = t + dt * ((r.kOut[i] + r.kFan[i]) * (outdoor - t) + r.heat[i]);
+    }
+}
+
+#ifdef SMARTHOME_X86_SIMD
+/**
+ * @brief SSE2 kernel: 4 rooms per instruction.
+ */
+__attribute__((target("sse2")))
+inline void stepSse2(const Rooms& r, float outdoor, float dt) {
+    __m128 out = _mm_set1_ps(outdoor), h = _mm_set1_ps(dt);
+    for (size_t i = 0; i < r.count; i += 4) {
+        __m128 t = _mm_load_ps(r.temp + i);
+        __m128 k = _mm_add_ps(_mm_load_ps(r.kOut + i), _mm_load_ps(r.kFan + i));
+        __m128 rate = _mm_add_ps(_mm_mul_ps(k, _mm_sub_ps(out, t)), _mm_load_ps(r.heat + i));
+        _mm_store_ps(r.temp + i, _mm_add_ps(t, _mm_mul_ps(h, rate)));
+    }
+}
+
+/**
+ * @brief AVX2 kernel: 8 rooms per instruction.
+ */
+__attribute__((target("avx2")))
+inline void stepAvx2(const Rooms& r, float outdoor, float dt) {
+    __m256 out = _mm256_set1_ps(outdoor), h = _mm256_set1_ps(dt);
+    for (size_t i = 0; i < r.count; i += 8) {
+        __m256 t = _mm256_load_ps(r.temp + i);
+        __m256 k = _mm256_add_ps(_mm256_load_ps(r.kOut + i), _mm256_load_ps(r.kFan + i));
+        __m256 rate = _mm256_add_ps(_mm256_mul_ps(k, _mm256_sub_ps(out, t)), _mm256_load_ps(r.heat + i));
+        _mm256_store_ps(r.temp + i, _mm256_add_ps(t, _mm256_mul_ps(h, rate)));
+    }
+}
+#endif
+
+/**
+ * @brief Picks the widest kernel the running CPU supports.
+ * @param name Receives the kernel's name for reporting
+ */
+inline Kernel select(const char*& name) {
+#ifdef SMARTHOME_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) { name = "AVX2"; return stepAvx2; }
+    if (__builtin_cpu_supports("sse2")) { name = "SSE2"; return stepSse2; }
+#endif
+    name = "scalar";
+    return stepScalar;
+}
+
+} // namespace thermal_kernels
+
+class ThermalModel : public SensorListener {
+public:
+    static constexpr SimTime STEP = SimClock::SECOND;  ///< Integration and publish interval
+    static constexpr SimTime NEVER = -1;               ///< nextDue() without any rooms
+    static constexpr float ENVELOPE_COUPLING = 0.5f;   ///< Default room-to-outdoor coupling, per hour
+    static constexpr float FAN_COUPLING = 2.0f;        ///< Extra coupling of a fan at 100% speed, per hour
+    static constexpr float THERMOSTAT_RATE = 20.0f;    ///< Heating of a thermostat at full power, degrees per hour
+    static constexpr float SENSOR_DEADBAND = 0.1f;     ///< Deadband given to the room sensors
+
+private:
+    // Per-room state, padded to a multiple of 8 rooms
+    AlignedVector<float> temp;
+    AlignedVector<float> kOut;
+    AlignedVector<float> kFan;
+    AlignedVector<float> heat;
+    std::vector<Sensor*> roomSensors;            ///< Per-room sensor
+    std::vector<std::vector<int>> roomDevices;   ///< Per-room actuator slots
+    std::vector<int> roomOfZone;                 ///< Zone index -> room (-1 = not modeled)
+    std::vector<int> roomOfSensor;               ///< Sensor handle -> room (-1 = not a room sensor)
+
+    // Per-actuator state (Fans and Thermostats)
+    std::vector<SmartDevice*> devices;
+    std::vector<uint8_t> isFan;                  ///< 1 = Fan, 0 = Thermostat
+    std::vector<int> deviceId;                   ///< Device handle (for the global on-state bitset)
+    std::vector<int> pidOf;                      ///< Thermostat's controller slot (-1 for fans)
+    std::vector<int> deviceRoom;                 ///< Room of each actuator (-1 = not in a modeled room)
+    std::vector<uint8_t> above;                  ///< Last above/below state seen from the room sensor
+    std::vector<int> slotById;                   ///< Device handle -> actuator slot (-1 = none)
+
+    float outdoor = 15.0f;                       ///< Outdoor temperature
+    SimTime lastStep = 0;                        ///< Instant of the last integration step
+    thermal_kernels::Kernel kernel;              ///< Selected integration kernel
+    const char* kernelName = "scalar";           ///< Name of the selected kernel
+
+    long long steps = 0;                         ///< Integration steps taken
+    long long crossings = 0;                     ///< Device notifications sent
+    double gatherSeconds = 0, pidSeconds = 0, kernelSeconds = 0, publishSeconds = 0;  ///< Wall time per phase
+
+public:
+    /**
+     * @brief Constructs a model without rooms and selects the integration kernel.
+     */
+    ThermalModel() { kernel = thermal_kernels::select(kernelName); }
+
+    /**
+     * @brief Starts modeling a room.
+     *
+     * The model subscribes to `sensor` and publishes the room's temperature
+     * through it; the sensor gets a small deadband so steady temperatures are
+     * not fanned out every second.
+     *
+     * @param zone Zone index of the room
+     * @param sensor The room's temperature sensor
+     * @param startTemp Initial temperature
+     * @return false if the zone is already modeled
+     */
+    bool addRoom(int zone, Sensor* sensor, float startTemp) {
+        if (zone < static_cast<int>(roomOfZone.size()) && roomOfZone[zone] >= 0) return false;
+        if (roomSensors.empty()) lastStep = SimClock::now();
+
+        size_t room = roomSensors.size();
+        if (room % 8 == 0) {
+            size_t padded = room + 8;
+            temp.resize(padded, 0.0f);
+            kOut.resize(padded, 0.0f);
+            kFan.resize(padded, 0.0f);
+            heat.resize(padded, 0.0f);
+        }
+        temp[room] = startTemp;
+        kOut[room] = ENVELOPE_COUPLING;
+        roomSensors.push_back(sensor);
+        roomDevices.emplace_back();
+
+        if (zone >= static_cast<int>(roomOfZone.size())) roomOfZone.resize(zone + 1, -1);
+        roomOfZone[zone] = static_cast<int>(room);
+        int handle = sensor->getHandle();
+        if (handle >= static_cast<int>(roomOfSensor.size())) roomOfSensor.resize(handle + 1, -1);
+        roomOfSensor[handle] = static_cast<int>(room);
+
+        PublishPolicy policy = sensor->getPolicy();
+        policy.deadband = SENSOR_DEADBAND;
+        sensor->setPolicy(policy);
+        sensor->subscribe(this);
+        return true;
+    }
+
+    /**
+     * @brief Records that a device is now in a zone.
+     *
+     * Fans and Thermostats in a modeled room act on that room; in any other
+     * zone they act on nothing. Other device types are ignored.
+     *
+     * @param d The device that moved or was added
+     * @param zone Its new zone index
+     */
+    void placeDevice(SmartDevice* d, int zone) {
+        bool fan = dynamic_cast<Fan*>(d) != nullptr;
+        if (!fan && !dynamic_cast<Thermostat*>(d)) return;
+
+        int id = d->getId();
+        if (id >= static_cast<int>(slotById.size())) slotById.resize(id + 1, -1);
+        int slot = slotById[id];
+        if (slot < 0) {
+            slot = static_cast<int>(devices.size());
+            slotById[id] = slot;
+            devices.push_back(d);
+            isFan.push_back(fan);
+            deviceId.push_back(id);
+            pidOf.push_back(fan ? -1 : static_cast<Thermostat*>(d)->getPid());
+            deviceRoom.push_back(-1);
+            above.push_back(0);
+        }
+
+        int room = zone < static_cast<int>(roomOfZone.size()) ? roomOfZone[zone] : -1;
+        if (deviceRoom[slot] == room) return;
+        if (deviceRoom[slot] >= 0) {
+            std::vector<int>& old = roomDevices[deviceRoom[slot]];
+            old.erase(std::find(old.begin(), old.end(), slot));
+        }
+        deviceRoom[slot] = room;
+        above[slot] = 0;
+        if (room >= 0) roomDevices[room].push_back(slot);
+        if (pidOf[slot] >= 0) {
+            PidBank& pids = Thermostat::getControllers();
+            if (room >= 0) pids.connect(pidOf[slot], room, temp[room]);
+            else pids.disconnect(pidOf[slot]);
+        }
+    }
+
+    /**
+     * @brief Sets the outdoor temperature.
+     */
+    void setOutdoor(float t) { outdoor = t; }
+
+    /**
+     * @brief Returns the number of modeled rooms.
+     */
+    size_t roomCount() const { return roomSensors.size(); }
+
+    /**
+     * @brief Returns the instant of the next step, or NEVER without rooms.
+     */
+    SimTime nextDue() const { return roomSensors.empty() ? NEVER : lastStep + STEP; }
+
+    /**
+     * @brief Restarts stepping from `now` (e.g., after the clock was reset).
+     */
+    void restart(SimTime now) { lastStep = now; }
+
+    /**
+     * @brief Takes every step that is due by `now`, then publishes the room temperatures.
+     * @param now Current simulated time
+     */
+    void update(SimTime now) {
+        if (roomSensors.empty() || now < lastStep + STEP) return;
+        using Clock = std::chrono::steady_clock;
+        const float dt = static_cast<float>(SimClock::toSeconds(STEP) / 3600.0);  // Rates are per hour
+        thermal_kernels::Rooms rooms{temp.data(), kOut.data(), kFan.data(), heat.data(), temp.size()};
+
+        auto t0 = Clock::now();
+        gather();
+        auto t1 = Clock::now();
+        for (; lastStep + STEP <= now; lastStep += STEP) {
+            auto p0 = Clock::now();
+            applyControllers();
+            auto p1 = Clock::now();
+            kernel(rooms, outdoor, dt);
+            pidSeconds += std::chrono::duration<double>(p1 - p0).count();
+            kernelSeconds += std::chrono::duration<double>(Clock::now() - p1).count();
+            steps++;
+        }
+        auto t2 = Clock::now();
+        for (size_t r = 0; r < roomSensors.size(); ++r) {
+            roomSensors[r]->publish(SensorReading::ofFloat(temp[r]));
+        }
+        auto t3 = Clock::now();
+        gatherSeconds += std::chrono::duration<double>(t1 - t0).count();
+        publishSeconds += std::chrono::duration<double>(t3 - t2).count();
+    }
+
+    /**
+     * @brief Compares a room reading with the thresholds of the room's devices
+     * and notifies those whose above/below state flipped.
+     * @param reading The published reading
+     */
+    void onSensorReading(const SensorReading& reading) override {
+        if (reading.sensor >= static_cast<int>(roomOfSensor.size())) return;
+        int room = roomOfSensor[reading.sensor];
+        if (room < 0) return;
+        float value = reading.asFloat();
+        for (int slot : roomDevices[room]) {
+            float threshold = isFan[slot] ? static_cast<Fan*>(devices[slot])->getThreshold()
+                                          : static_cast<Thermostat*>(devices[slot])->getThreshold();
+            uint8_t now = value > threshold;
+            if (now == above[slot]) continue;
+            above[slot] = now;
+            devices[slot]->onThresholdCrossed(now);
+            crossings++;
+        }
+    }
+
+    /**
+     * @brief Prints the room temperatures, their devices and the step counters.
+     */
+    void printRooms() const {
+        std::cout << "\n=== Thermal Model (" << kernelName << " kernel, outdoor "
+                  << outdoor << "C) ===\n";
+        for (size_t r = 0; r < roomSensors.size(); ++r) {
+            std::cout << "- " << roomSensors[r]->getId() << ": " << temp[r] << "C";
+            for (int slot : roomDevices[r]) {
+                std::cout << (slot == roomDevices[r].front() ? "  [" : ", ") << devices[slot]->getName()
+                          << (devices[slot]->getState() ? " ON" : " OFF");
+                if (pidOf[slot] >= 0) {
+                    const PidBank& pids = Thermostat::getControllers();
+                    std::cout << " set " << pids.getSetpoint(pidOf[slot]) << "C, output "
+                              << static_cast<int>(pids.getOutput(pidOf[slot]) * 100.0f) << "%";
+                }
+            }
+            std::cout << (roomDevices[r].empty() ? "" : "]") << "\n";
+        }
+        std::cout << "Steps: " << steps << ", device notifications: " << crossings << ", PID controllers: "
+                  << Thermostat::getControllers().size() << " (" << Thermostat::getControllers().getKernelName()
+                  << " kernel)\n";
+        if (steps > 0) {
+            std::cout << "Per step: gather " << gatherSeconds * 1e6 / steps << " us, PID " << pidSeconds * 1e6 / steps
+                      << " us, kernel " << kernelSeconds * 1e6 / steps << " us, publish "
+                      << publishSeconds * 1e6 / steps << " us\n";
+        }
+        std::cout << "===========================\n";
+    }
+
+private:
+    /**
+     * @brief Rebuilds the fan coupling and enables the controllers of running
+     * thermostats, from the devices' current state.
+     */
+    void gather() {
+        std::fill(kFan.begin(), kFan.end(), 0.0f);
+        const DeviceSet& on = SmartDevice::getOnDevices();
+        PidBank& pids = Thermostat::getControllers();
+        for (size_t slot = 0; slot < devices.size(); ++slot) {
+            int room = deviceRoom[slot];
+            if (room < 0) continue;
+            bool running = on.test(deviceId[slot]);
+            if (!isFan[slot]) {
+                pids.setEnabled(pidOf[slot], running, temp[room]);
+            } else if (running) {
+                kFan[room] += FAN_COUPLING * static_cast<Fan*>(devices[slot])->getSpeed() / 100.0f;
+            }
+        }
+    }
+
+    /**
+     * @brief Steps all thermostat controllers against the current room
+     * temperatures and sums their outputs per room.
+     */
+    void applyControllers() {
+        PidBank& pids = Thermostat::getControllers();
+        pids.update(temp.data(), static_cast<float>(SimClock::toSeconds(STEP)));
+        std::fill(heat.begin(), heat.end(), 0.0f);
+        for (size_t slot = 0; slot < devices.size(); ++slot) {
+            if (pidOf[slot] < 0 || deviceRoom[slot] < 0) continue;
+            heat[deviceRoom[slot]] += THERMOSTAT_RATE * pids.getOutput(pidOf[slot]);
+        }
+    }
+};
+
+#endif // THERMAL_MODEL_H
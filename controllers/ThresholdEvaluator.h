@@ -0,0 +1,206 @@
+/**
+ * @file ThresholdEvaluator.h
+ * @brief Vectorized evaluation of per-device temperature thresholds.
+ *
+ * The `ThresholdEvaluator` class stores a reaction threshold for every registered
+ * device in an aligned array indexed by device handle (unregistered handles hold
+ * +inf and never fire) and evaluates a new reading against all of them at once. The comparison kernel produces an on/off bitmask (bit = reading above the
+ * device's threshold) using AVX2 or SSE2 when the CPU supports it, selected at
+ * runtime, with a portable scalar fallback. For devices whose reaction is to
+ * switch ON above and OFF below (Fans), the mask is diffed against their actual
+ * state, read word by word from SmartDevice::getOnDevices() (which shares the
+ * handle layout), so a device switched by hand is brought
+ * back in line by the next reading. For the others (e.g., Thermostats, which
+ * change mode) it is diffed against the previous mask. Only devices whose bit
+ * differs receive `onThresholdCrossed()`, so a reading that changes nothing
+ * costs one pass over the array and no calls.
+ *
+ * Responsibilities:
+ * - Keep thresholds in a padded, 32-byte aligned array indexed by device handle
+ * - Evaluate readings with the best available SIMD kernel
+ * - Notify only the devices whose state or above/below side disagrees with the reading
+ *
+ * Design Pattern:
+ * - Observer Pattern: subscribes to temperature sensors as a `SensorListener`
+ *   and drives the subscribed devices on their behalf.
+ */
+
+#ifndef THRESHOLD_EVALUATOR_H
+#define THRESHOLD_EVALUATOR_H
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "../models/SmartDevice.h"
+#include "../models/sensor/SensorListener.h"
+#include "../utils/AlignedAllocator.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SMARTHOME_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace threshold_kernels {
+
+using Kernel = void (*)(const float* thresholds, size_t words, float value, uint64_t* out);
+
+/**
+ * @brief Portable kernel: one comparison per device.
+ */
+inline void evaluateScalar(const float* thresholds, size_t words, float value, uint64_t* out) {
+    for (size_t w = 0; w < words; ++w) {
+        const float* t = thresholds + w * 64;
+        uint64_t bits = 0;
+        for (int i = 0; i < 64; ++i) bits |= static_cast<uint64_t>(value > t[i]) << i;
+        out[w] = bits;
+    }
+}
+
+#ifdef SMARTHOME_X86_SIMD
+/**
+ * @brief SSE2 kernel: 4 devices per comparison.
+ */
+__attribute__((target("sse2")))
+inline void evaluateSse2(const float* thresholds, size_t words, float value, uint64_t* out) {
+    __m128 v = _mm_set1_ps(value);
+    for (size_t w = 0; w < words; ++w) {
+        const float* t = thresholds + w * 64;
+        uint64_t bits = 0;
+        for (int k = 0; k < 16; ++k) {
+            __m128 above = _mm_cmpgt_ps(v, _mm_load_ps(t + k * 4));
+            bits |= static_cast<uint64_t>(_mm_movemask_ps(above)) << (k * 4);
+        }
+        out[w] = bits;
+    }
+}
+
+/**
+ * @brief AVX2 kernel: 8 devices per comparison.
+ */
+__attribute__((target("avx2")))
+inline void evaluateAvx2(const float* thresholds, size_t words, float value, uint64_t* out) {
+    __m256 v = _mm256_set1_ps(value);
+    for (size_t w = 0; w < words; ++w) {
+        const float* t = thresholds + w * 64;
+        uint64_t bits = 0;
+        for (int k = 0; k < 8; ++k) {
+            __m256 above = _mm256_cmp_ps(v, _mm256_load_ps(t + k * 8), _CMP_GT_OQ);
+            bits |= static_cast<uint64_t>(static_cast<unsigned>(_mm256_movemask_ps(above))) << (k * 8);
+        }
+        out[w] = bits;
+    }
+}
+#endif
+
+/**
+ * @brief Picks the widest kernel the running CPU supports.
+ * @param name Receives the kernel's name for reporting
+ */
+inline Kernel select(const char*& name) {
+#ifdef SMARTHOME_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) { name = "AVX2"; return evaluateAvx2; }
+    if (__builtin_cpu_supports("sse2")) { name = "SSE2"; return evaluateSse2; }
+#endif
+    name = "scalar";
+    return evaluateScalar;
+}
+
+} // namespace threshold_kernels
+
+class ThresholdEvaluator : public SensorListener {
+    AlignedVector<float> thresholds;       ///< Per-handle thresholds, padded to 64 with +inf
+    std::vector<SmartDevice*> devices;     ///< Per-handle device (nullptr = not registered)
+    std::vector<uint64_t> above;           ///< Current bitmask (bit set = above threshold)
+    std::vector<uint64_t> switching;       ///< Bit set = the device's reaction is ON/OFF (diffed against its state)
+    std::vector<uint64_t> scratch;         ///< Kernel output for the reading being evaluated
+    threshold_kernels::Kernel kernel;      ///< Selected comparison kernel
+    const char* kernelName = "scalar";     ///< Name of the selected kernel
+    long long evaluations = 0;             ///< Readings evaluated
+    long long crossings = 0;               ///< Device notifications sent
+
+public:
+    /**
+     * @brief Constructs an empty evaluator and selects the comparison kernel.
+     */
+    ThresholdEvaluator() { kernel = threshold_kernels::select(kernelName); }
+
+    /**
+     * @brief Registers a device with its reaction threshold.
+     * @param device Device to drive (e.g., a Fan or Thermostat)
+     * @param threshold Readings strictly above this value count as "above"
+     */
+    void add(SmartDevice* device, float threshold) {
+        size_t id = static_cast<size_t>(device->getId());
+        if (id >= devices.size()) {
+            size_t words = id / 64 + 1;
+            devices.resize(words * 64, nullptr);
+            thresholds.resize(words * 64, std::numeric_limits<float>::infinity());
+            above.resize(words, 0);
+            switching.resize(words, 0);
+            scratch.resize(words, 0);
+        }
+        devices[id] = device;
+        thresholds[id] = threshold;
+        if (device->thresholdSwitchesPower()) switching[id / 64] |= uint64_t(1) << (id % 64);
+    }
+
+    /**
+     * @brief Changes the threshold of a registered device.
+     * @return false if the device is not registered
+     */
+    bool setThreshold(const SmartDevice* device, float threshold) {
+        size_t id = static_cast<size_t>(device->getId());
+        if (id >= devices.size() || !devices[id]) return false;
+        thresholds[id] = threshold;
+        return true;
+    }
+
+    /**
+     * @brief Evaluates temperature readings; other kinds are ignored.
+     * @param reading The published reading
+     */
+    void onSensorReading(const SensorReading& reading) override {
+        if (reading.kind == SensorKind::Temperature) evaluate(reading.asFloat());
+    }
+
+    /**
+     * @brief Compares a value against every threshold and notifies the devices that disagree.
+     * @param value The new reading
+     */
+    void evaluate(float value) {
+        evaluations++;
+        if (devices.empty()) return;
+        kernel(thresholds.data(), above.size(), value, scratch.data());
+
+        const DeviceSet& on = SmartDevice::getOnDevices();
+        for (size_t w = 0; w < above.size(); ++w) {
+            uint64_t state = on.word(w);
+            uint64_t changed = ((scratch[w] ^ above[w]) & ~switching[w]) | ((scratch[w] ^ state) & switching[w]);
+            above[w] = scratch[w];
+            while (changed) {
+                int bit = __builtin_ctzll(changed);
+                changed &= changed - 1;
+                devices[w * 64 + bit]->onThresholdCrossed((scratch[w] >> bit) & 1);
+                crossings++;
+            }
+        }
+    }
+
+    /**
+     * @brief Prints the registered thresholds and evaluation counters.
+     */
+    void printThresholds() const {
+        std::cout << "\n=== Reaction Thresholds (" << kernelName << " kernel) ===\n";
+        for (size_t i = 0; i < devices.size(); ++i) {
+            if (!devices[i]) continue;
+            std::cout << "- " << devices[i]->getName() << ": above " << thresholds[i]
+                      << (((above[i / 64] >> (i % 64)) & 1) ? " [above]" : " [below]") << "\n";
+        }
+        std::cout << "Evaluations: " << evaluations << ", device notifications: " << crossings << "\n";
+        std::cout << "===========================\n";
+    }
+};
+
+#endif // THRESHOLD_EVALUATOR_H
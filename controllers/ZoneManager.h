@@ -0,0 +1,188 @@
+/**
+ * @file ZoneManager.h
+ * @brief Home → floor → room hierarchy with bitset membership and group commands.
+ *
+ * The `ZoneManager` class organizes devices into a three-level tree rooted at
+ * "home". Every zone stores the handles of all devices in its subtree as a
+ * `DeviceSet`, so "everything on floor 2" is a ready-made bitset. Moving a
+ * device between rooms clears and sets one bit per ancestor instead of
+ * rebuilding any set.
+ *
+ * Zones are mirrored in the devices' `EnergyMeter`, so every zone also has
+ * running energy totals for its subtree.
+ *
+ * Group commands (`off floor2`, `on kitchen lights`) intersect the zone's set
+ * with the optional type set, subtract the devices already in the target state
+ * (using SmartDevice::getOnDevices()), and apply the rest inside one
+ * notification batch.
+ *
+ * Responsibilities:
+ * - Create floors and rooms under the home
+ * - Keep per-zone membership bitsets up to date incrementally
+ * - Resolve and apply group on/off commands
+ * - Print the zone tree
+ */
+
+#ifndef ZONE_MANAGER_H
+#define ZONE_MANAGER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DeviceController.h"
+#include "../models/SmartDevice.h"
+#include "../utils/DeviceSet.h"
+#include "../utils/SimClock.h"
+
+class ZoneManager {
+public:
+    /**
+     * @brief Depth of a zone in the hierarchy.
+     */
+    enum class Level { Home, Floor, Room };
+
+    /**
+     * @brief One node of the hierarchy.
+     */
+    struct Zone {
+        std::string name;
+        int parent;                 ///< Parent zone index (-1 for the home)
+        Level level;
+        std::vector<int> children;  ///< Child zone indices
+        DeviceSet members;          ///< Devices in this zone or any zone below it
+    };
+
+private:
+    DeviceController& controller;
+    std::vector<Zone> zones;        ///< Index 0 is the home
+    std::vector<int> zoneOf;        ///< Device handle -> innermost zone (-1 = none)
+
+public:
+    /**
+     * @brief Constructs a hierarchy containing only the home zone.
+     * @param devices Controller used to resolve handles and device types
+     */
+    explicit ZoneManager(DeviceController& devices) : controller(devices) {
+        zones.push_back(Zone{"home", -1, Level::Home, {}, {}});
+        SmartDevice::getEnergyMeter().addZone(0, -1);
+    }
+
+    /**
+     * @brief Creates a floor (under the home) or a room (under a floor).
+     * @param name Unique zone name
+     * @param parentName Name of the parent zone
+     * @return false if the name is taken, the parent is unknown or is a room
+     */
+    bool addZone(const std::string& name, const std::string& parentName) {
+        int parent = find(parentName);
+        if (find(name) >= 0 || parent < 0 || zones[parent].level == Level::Room) return false;
+        Level level = zones[parent].level == Level::Home ? Level::Floor : Level::Room;
+        zones.push_back(Zone{name, parent, level, {}, {}});
+        zones[parent].children.push_back(static_cast<int>(zones.size() - 1));
+        SmartDevice::getEnergyMeter().addZone(static_cast<int>(zones.size() - 1), parent);
+        return true;
+    }
+
+    /**
+     * @brief Returns the index of a zone by name, or -1.
+     */
+    int find(const std::string& name) const {
+        for (size_t z = 0; z < zones.size(); ++z) {
+            if (zones[z].name == name) return static_cast<int>(z);
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Registers a new device directly under the home.
+     */
+    void addDevice(SmartDevice* d) { assign(d, 0); }
+
+    /**
+     * @brief Moves a device into a zone, updating only the ancestors' bits.
+     * @param d Device to move
+     * @param zone Target zone index
+     */
+    void assign(SmartDevice* d, int zone) {
+        int id = d->getId();
+        if (id >= static_cast<int>(zoneOf.size())) zoneOf.resize(id + 1, -1);
+        for (int z = zoneOf[id]; z >= 0; z = zones[z].parent) zones[z].members.reset(id);
+        for (int z = zone; z >= 0; z = zones[z].parent) zones[z].members.set(id);
+        zoneOf[id] = zone;
+
+        EnergyMeter& energy = SmartDevice::getEnergyMeter();
+        if (energy.needsDevice(id)) energy.addDevice(id, d->getType(), d->getName());
+        energy.moveDevice(id, zone, SimClock::now());
+    }
+
+    /**
+     * @brief Returns whether a zone is the home, a floor or a room.
+     */
+    Level level(int zone) const { return zones[zone].level; }
+
+    /**
+     * @brief Returns the devices in a zone's subtree.
+     */
+    const DeviceSet& members(int zone) const { return zones[zone].members; }
+
+    /**
+     * @brief Turns every device of a zone (optionally of one type) on or off.
+     *
+     * Only devices not already in the target state are changed, all inside one
+     * notification batch.
+     *
+     * @param zone Zone index
+     * @param type Optional type filter (nullptr for all types)
+     * @param on Target state
+     * @return Number of devices changed
+     */
+    int apply(int zone, const DeviceSet* type, bool on) {
+        DeviceSet targets = zones[zone].members;
+        if (type) targets &= *type;
+        if (on) {
+            targets.andNot(SmartDevice::getOnDevices());
+        } else {
+            targets &= SmartDevice::getOnDevices();
+        }
+
+        int changed = 0;
+        SmartDevice::beginNotificationBatch();
+        targets.forEach([&](int id) {
+            if (SmartDevice* d = controller.getDeviceById(id)) {
+                d->setState(on);
+                changed++;
+            }
+        });
+        SmartDevice::endNotificationBatch();
+        return changed;
+    }
+
+    /**
+     * @brief Prints the hierarchy with device counts and the devices of each room.
+     */
+    void printZones() const {
+        std::cout << "\n=== Zones ===\n";
+        printZone(0, 0);
+        std::cout << "=============\n";
+    }
+
+private:
+    void printZone(int z, int depth) const {
+        static const char* levelNames[] = {"home", "floor", "room"};
+        const Zone& zone = zones[z];
+        std::cout << std::string(depth * 2, ' ') << "- " << zone.name << " ("
+                  << levelNames[static_cast<int>(zone.level)] << ", " << zone.members.count() << " devices)";
+        bool first = true;
+        for (size_t id = 0; id < zoneOf.size(); ++id) {
+            if (zoneOf[id] != z) continue;
+            SmartDevice* d = controller.getDeviceById(static_cast<int>(id));
+            if (!d) continue;
+            std::cout << (first ? ": " : ", ") << d->getName() << (d->getState() ? " [ON]" : "");
+            first = false;
+        }
+        std::cout << "\n";
+        for (int child : zone.children) printZone(child, depth + 1);
+    }
+};
+
+#endif // ZONE_MANAGER_H
@@ -15,21 +15,42 @@
  * Date: 07/15/2025
  */
 
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <vector>
 
 // Core project headers
 #include "controllers/DeviceController.h"
 #include "controllers/Scheduler.h"
+#include "controllers/ThresholdEvaluator.h"
+#include "controllers/RuleEngine.h"
+#include "controllers/ZoneManager.h"
+#include "controllers/SceneManager.h"
+#include "controllers/BehaviorRuntime.h"
+#include "controllers/ThermalModel.h"
 #include "utils/DeviceFactory.h"
 #include "observers/DeviceLogger.h"
+#include "observers/WriteAheadLog.h"
+#include "observers/ActivityRollup.h"
+#include "observers/SubscriptionTable.h"
+#include "utils/SimClock.h"
+#include "utils/TraceIngestor.h"
+#include "utils/ScheduleImporter.h"
+#include "utils/ControlServer.h"
+#include "utils/BinaryProtocol.h"
 #include "models/strategies/EcoMode.h"
 #include "models/strategies/ComfortMode.h"
 #include "models/Thermostat.h"
-#include "models/sensor/Sensor.h"
+#include "models/sensor/SensorRegistry.h"
 #include "strategies/scheduling/OneTimeSchedule.h"
 #include "strategies/scheduling/PeriodicSchedule.h"
 #include "strategies/scheduling/DelayedSchedule.h"
+#include "strategies/scheduling/CronSchedule.h"
+#include "behaviors/DeviceBehaviors.h"
 
 /**
  * @brief Prints the main CLI menu.
@@ -39,11 +60,58 @@ void printMenu() {
     std::cout << "Commands:\n";
     std::cout << "  <name>      - Toggle a device on/off by name\n";
     std::cout << "  add         - Add a new smart device\n";
-    std::cout << "  sensor      - Simulate a sensor event\n";
+    std::cout << "  sensor      - Simulate a sensor event on the default temperature sensor\n";
+    std::cout << "  sensor <id> <value> - Publish a reading from a specific sensor\n";
+    std::cout << "  sensor-history <id> <window> - Summarize a sensor's readings (e.g., 10m, 24h)\n";
+    std::cout << "  ingest <file> [sensor-id] - Replay a recorded CSV/binary sensor trace at full speed\n";
+    std::cout << "  sensor-config <id> <deadband> <min-change-%> <min-interval> | off - Tune change suppression\n";
+    std::cout << "  threshold <value> <device> - Set the reaction threshold of a fan or thermostat\n";
+    std::cout << "  thresholds  - Show reaction thresholds and evaluation counters\n";
+    std::cout << "  setpoint <temp> <thermostat> - Set the temperature a thermostat's PID controller holds\n";
+    std::cout << "  pid <kp> <ki> <kd> <thermostat> - Tune a thermostat's PID gains\n";
+    std::cout << "  sensors     - List registered sensors and their latest readings\n";
+    std::cout << "  add-sensor <id> <kind> - Add a temperature/humidity/motion/light sensor\n";
+    std::cout << "  subscribe <sensor-id|kind> <device> - Subscribe a device to a sensor or kind\n";
+    std::cout << "  rule <text> - Add an automation rule, e.g. if temp > 30 and time between 22:00-06:00 then Bedroom Fan ON\n";
+    std::cout << "  rules-load <file> - Load automation rules from a file (one per line)\n";
+    std::cout << "  rules       - Show automation rules and evaluation throughput\n";
+    std::cout << "  rules-clear - Remove all automation rules\n";
+    std::cout << "  zone <name> [parent] - Add a floor (under home) or a room (under a floor)\n";
+    std::cout << "  assign <zone> <device> - Move a device into a zone\n";
+    std::cout << "  zones       - Show the home/floor/room hierarchy\n";
+    std::cout << "  thermal-add <room> [temp] - Model a room's temperature and publish it on <room>-temp\n";
+    std::cout << "  thermal     - Show modeled room temperatures and step cost\n";
+    std::cout << "  outdoor <temp> - Set the outdoor temperature of the thermal model\n";
+    std::cout << "  on <zone> [type] / off <zone> [type] - Switch a zone's devices (e.g., off floor2, on kitchen lights)\n";
+    std::cout << "  scene-save <name> [zone] - Save the current state of a zone's devices as a scene\n";
+    std::cout << "  scene-set <name> <on|off> <device> - Set one device's target state in a scene\n";
+    std::cout << "  scene <name> - Activate a scene (only devices not in their target state change)\n";
+    std::cout << "  scenes      - List scenes\n";
     std::cout << "  list        - Show all registered devices\n";
+    std::cout << "  ramp <speed-%> <duration> <fan> - Ramp a fan's speed over time (e.g., ramp 100 30s Bedroom Fan)\n";
+    std::cout << "  fade <brightness-%> <duration> <light> - Fade a light over time (e.g., fade 0 5m LivingRoom Light)\n";
+    std::cout << "  preheat <temp> <ramp> <hold> <thermostat> - Raise a thermostat's setpoint, then hold it\n";
+    std::cout << "  behaviors   - Show running device behaviors\n";
+    std::cout << "  behavior-stop <device> - Stop the behavior running on a device\n";
     std::cout << "  tick        - Advance simulated time by 1 second\n";
+    std::cout << "  advance <duration> - Fast-forward simulated time (e.g., 0.25, 500ms, 10m, 7d)\n";
     std::cout << "  schedule    - Schedule device action using a timing strategy\n";
+    std::cout << "  schedule-import <file> - Bulk-load tasks (lines of device,on|off,at|after|every|cron,value)\n";
+    std::cout << "  schedules   - List scheduled tasks with their IDs\n";
+    std::cout << "  unschedule <id> - Cancel a scheduled task\n";
+    std::cout << "  schedule-policy <warn|keep-first|keep-last> - Resolve same-instant conflicts\n";
+    std::cout << "  conflicts   - Show detected schedule conflicts\n";
+    std::cout << "  energy [zone|device] - Show energy used by the home, a zone or a device\n";
+    std::cout << "  energy-report - Show wattage and energy of every device\n";
+    std::cout << "  watts <W> <device|type> - Set the wattage of a device or a device type\n";
     std::cout << "  logs        - Show logged device activity\n";
+    std::cout << "  logs <device|type> [--from <t>] [--to <t>] - Show activity of a device or type in a time range\n";
+    std::cout << "  stats       - Show per-device transition counts, ON time and duty cycle\n";
+    std::cout << "  notify-stats - Show how many observer notifications were coalesced\n";
+    std::cout << "  wal         - Show write-ahead log commit statistics\n";
+    std::cout << "  wal-window <us> - Set the group commit window in microseconds\n";
+    std::cout << "  checkpoint  - Snapshot device states and truncate the log\n";
+    std::cout << "  server-stats - Show control server throughput and latency (server mode)\n";
     std::cout << "  reset       - Reset simulation time and tasks\n";
     std::cout << "  exit        - Quit the simulation\n";
     std::cout << "==================================\n";
@@ -51,9 +119,32 @@ void printMenu() {
 
 /**
  * @brief Main entry point for SmartHomeSim.
+ *
+ * Without arguments the simulation is controlled from stdin. With `--unix <path>`
+ * and/or `--tcp <port>` it runs as a control server for local clients instead;
+ * `--binary-unix <path>` and `--binary-tcp <port>` serve the binary protocol.
  */
-int main() {
-    int currentTime = 0;
+int main(int argc, char* argv[]) {
+    std::string unixPath, binaryUnixPath;
+    int tcpPort = 0, binaryTcpPort = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--unix" && i + 1 < argc) {
+            unixPath = argv[++i];
+        } else if (arg == "--tcp" && i + 1 < argc) {
+            tcpPort = std::atoi(argv[++i]);
+        } else if (arg == "--binary-unix" && i + 1 < argc) {
+            binaryUnixPath = argv[++i];
+        } else if (arg == "--binary-tcp" && i + 1 < argc) {
+            binaryTcpPort = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--unix <socket-path>] [--tcp <port>]"
+                      << " [--binary-unix <socket-path>] [--binary-tcp <port>]\n";
+            return 1;
+        }
+    }
+
+    SimTime currentTime = 0;
     DeviceController controller;
 
     // Initial device setup
@@ -64,49 +155,123 @@ int main() {
     controller.addDevice(fan);
     controller.addDevice(thermostat);
 
-    // Attach logger to all devices
+    // Attach logger to all devices (one global subscription covers devices added later)
     DeviceLogger* logger = new DeviceLogger();
-    light->attach(logger);
-    fan->attach(logger);
-    thermostat->attach(logger);
+    SubscriptionTable::instance().subscribeAll(logger);
+
+    // Constant-memory per-device aggregates (hourly buckets)
+    ActivityRollup rollup;
+    SubscriptionTable::instance().subscribeAll(&rollup);
+
+    // Sensor setup (Observer Pattern): temperature readings reach Fans and Thermostats
+    // through the vectorized threshold evaluator, other devices directly
+    SensorRegistry sensors;
+    sensors.addSensor("temp", SensorKind::Temperature);
+    ThresholdEvaluator thresholds;
+    sensors.subscribeKind(SensorKind::Temperature, &thresholds);
 
-    // Thermostat uses Strategy Pattern (EcoMode)
-    Thermostat* t = dynamic_cast<Thermostat*>(thermostat);
-    if (t) t->setStrategy(new EcoMode());
+    // Home -> floor -> room hierarchy; new devices start directly under the home
+    ZoneManager zones(controller);
+    SceneManager scenes(controller);
 
-    // Sensor setup (Observer Pattern)
-    Sensor sensor;
-    sensor.subscribe(light);
-    sensor.subscribe(fan);
-    sensor.subscribe(thermostat);
+    auto wireDevice = [&](SmartDevice* d) {
+        zones.addDevice(d);
+        if (Fan* f = dynamic_cast<Fan*>(d)) {
+            thresholds.add(f, f->getThreshold());
+        } else if (Thermostat* th = dynamic_cast<Thermostat*>(d)) {
+            th->setStrategy(new EcoMode());  // Thermostat uses Strategy Pattern (EcoMode)
+            thresholds.add(th, th->getThreshold());
+        } else {
+            sensors.subscribeKind(SensorKind::Temperature, d);
+        }
+    };
+    wireDevice(light);
+    wireDevice(fan);
+    wireDevice(thermostat);
+
+    // Durability: restore states from the last snapshot + log, then log every transition
+    WriteAheadLog wal("smarthome.wal", "smarthome.snapshot");
+    int replayed = wal.recover([&](const std::string& type, const std::string& name) {
+        SmartDevice* d = controller.findDevice(name);
+        if (d) return d;
+        d = DeviceFactory::createDevice(type, name);
+        if (d) {
+            controller.addDevice(d);
+            wireDevice(d);
+        }
+        return d;
+    });
+    if (replayed > 0) std::cout << "[WAL] Recovered " << replayed << " state transitions.\n";
+    SubscriptionTable::instance().subscribeAll(&wal);
+
+    // User-defined automation rules, matched incrementally on sensor readings, ticks
+    // and state changes of the devices their conditions name
+    RuleEngine rules(controller, sensors);
+    for (int k = 0; k < SENSOR_KIND_COUNT; ++k) sensors.subscribeKind(static_cast<SensorKind>(k), &rules);
 
     // Scheduler setup (Strategy Pattern for time-based behavior)
     Scheduler scheduler(&controller.getAllDevices());
 
-    // CLI Loop
-    std::string command;
-    while (true) {
-        printMenu();
-        std::cout << "\nEnter command : ";
-        std::getline(std::cin, command);
+    // Multi-step device behaviors (coroutines suspended on simulated time)
+    BehaviorRuntime behaviors;
+
+    // Room temperatures stepped every simulated second; each room's Fans and
+    // Thermostats react to its own sensor
+    ThermalModel thermal;
 
-        if (command == "exit") break;
+    // Deferred notifications: each command is one batch, delivered before the next prompt
+    SmartDevice::beginNotificationBatch();
+
+    // Delivers pending changes; observers (e.g., rules) may change devices while a
+    // batch is delivered, so drain a few rounds
+    auto settle = [&]() {
+        for (int round = 0; round < 8 && SmartDevice::hasPendingNotifications(); ++round) {
+            SmartDevice::flushNotifications();
+        }
+    };
+
+    // Earliest instant at which a task, a behavior or a thermal step is due, or NEVER
+    auto nextDue = [&]() {
+        SimTime next = SchedulingStrategy::NEVER;
+        for (SimTime due : {scheduler.nextDue(), behaviors.nextDue(), thermal.nextDue()}) {
+            if (due != SchedulingStrategy::NEVER && (next == SchedulingStrategy::NEVER || due < next)) next = due;
+        }
+        return next;
+    };
+
+    // Moves simulated time to `target`, visiting only the instants at which tasks,
+    // behaviors or thermal steps are due. Everything due at one instant fires as one batch and
+    // is delivered with the clock still at that instant.
+    auto advanceTo = [&](SimTime target) {
+        for (SimTime next = nextDue(); next != SchedulingStrategy::NEVER && next <= target; next = nextDue()) {
+            SimClock::set(next);
+            scheduler.update(next);
+            behaviors.update(next);
+            thermal.update(next);
+            rules.onTick(next);
+            settle();
+        }
+        currentTime = target;
+        SimClock::set(currentTime);
+        rules.onTick(currentTime);
+    };
+
+    // Executes one command; commands that prompt for more (add, sensor, schedule)
+    // read it from `input`. Returns false for "exit".
+    ControlServer* server = nullptr;
+    auto execute = [&](const std::string& command, std::istream& input) {
+        if (command == "exit") return false;
 
         else if (command == "add") {
             std::string type, name;
             std::cout << "Enter device type (Light/Fan/Thermostat): ";
-            std::getline(std::cin, type);
+            std::getline(input, type);
             std::cout << "Enter device name: ";
-            std::getline(std::cin, name);
+            std::getline(input, name);
             SmartDevice* newDevice = DeviceFactory::createDevice(type, name);
             if (newDevice) {
                 controller.addDevice(newDevice);
-                newDevice->attach(logger);
-                sensor.subscribe(newDevice);
-                if (type == "Thermostat") {
-                    Thermostat* th = dynamic_cast<Thermostat*>(newDevice);
-                    if (th) th->setStrategy(new EcoMode());
-                }
+                wireDevice(newDevice);
                 std::cout << "[System] " << type << " \"" << name << "\" added successfully.\n";
             } else {
                 std::cout << "[Error] Invalid device type.\n";
@@ -114,65 +279,697 @@ int main() {
         }
 
         else if (command == "sensor") {
+            std::string text;
             int value;
             std::cout << "Enter sensor value (e.g., temperature): ";
-            std::cin >> value;
-            std::cin.ignore();
-            sensor.trigger(value);
+            std::getline(input, text);
+            std::istringstream in(text);
+            if (in >> value) sensors.find("temp")->trigger(value);
+            else std::cout << "[Error] Invalid sensor value.\n";
+        }
+
+        else if (command.rfind("sensor ", 0) == 0) {
+            std::istringstream in(command.substr(7));
+            std::string id, text;
+            in >> id >> text;
+            Sensor* s = sensors.find(id);
+            SensorReading reading;
+            if (!s) {
+                std::cout << "[Error] Unknown sensor \"" << id << "\".\n";
+            } else if (!SensorRegistry::parseReading(*s, text, reading)) {
+                std::cout << "[Error] Invalid " << sensorKindName(s->getKind()) << " value.\n";
+            } else {
+                s->publish(reading);
+            }
+        }
+
+        else if (command.rfind("sensor-history ", 0) == 0) {
+            // sensor-history <id> <window>, window in seconds or with a unit suffix
+            std::istringstream in(command.substr(15));
+            std::string id, windowText;
+            in >> id >> windowText;
+            Sensor* s = sensors.find(id);
+            SimTime window = 0;
+            SimClock::parseDuration(windowText, window);
+            if (!s) {
+                std::cout << "[Error] Unknown sensor \"" << id << "\".\n";
+            } else if (window <= 0) {
+                std::cout << "[Error] Window must be a positive duration (e.g., 600, 10m, 24h).\n";
+            } else {
+                std::cout << "\n=== History of " << id << " over the last " << SimClock::format(window) << " ===\n";
+                s->getHistory().print(currentTime, window);
+                std::cout << "==========================\n";
+            }
+        }
+
+        else if (command.rfind("ingest ", 0) == 0) {
+            // ingest <file> [default-sensor-id]
+            std::istringstream in(command.substr(7));
+            std::string path, id = "temp";
+            in >> path >> id;
+            Sensor* target = sensors.find(id);
+            // Tasks, behaviors and thermal steps due between readings run on the way
+            TraceIngestor ingestor(sensors, advanceTo);
+            TraceIngestor::Result result = ingestor.ingest(path, target, currentTime);
+            TraceIngestor::printResult(path, result);
+        }
+
+        else if (command.rfind("sensor-config ", 0) == 0) {
+            // sensor-config <id> <deadband> <min-change-%> <min-interval> | sensor-config <id> off
+            std::istringstream in(command.substr(14));
+            std::string id, first;
+            in >> id >> first;
+            Sensor* s = sensors.find(id);
+            PublishPolicy policy;
+            float minChangePct = 0.0f;
+            std::string intervalText;
+            if (!s) {
+                std::cout << "[Error] Unknown sensor \"" << id << "\".\n";
+            } else if (first == "off") {
+                policy.enabled = false;
+                s->setPolicy(policy);
+                std::cout << "[System] Change suppression disabled for " << id << ".\n";
+            } else {
+                std::istringstream values(first);
+                if ((values >> policy.deadband) && (in >> minChangePct >> intervalText)
+                    && SimClock::parseDuration(intervalText, policy.minInterval) && policy.minInterval >= 0) {
+                    policy.minChange = minChangePct / 100.0f;
+                    s->setPolicy(policy);
+                    std::cout << "[System] Suppression for " << id << ": deadband " << policy.deadband
+                              << ", min change " << minChangePct << "%, min interval "
+                              << SimClock::format(policy.minInterval) << ".\n";
+                } else {
+                    std::cout << "[Error] Usage: sensor-config <id> <deadband> <min-change-%> <min-interval>\n";
+                }
+            }
+        }
+
+        else if (command.rfind("threshold ", 0) == 0) {
+            // threshold <value> <device name>
+            std::string rest = command.substr(10);
+            size_t space = rest.find(' ');
+            SmartDevice* d = space == std::string::npos ? nullptr : controller.findDevice(rest.substr(space + 1));
+            float value = 0.0f;
+            try { value = std::stof(rest.substr(0, space)); } catch (const std::exception&) { d = nullptr; }
+            Fan* f = dynamic_cast<Fan*>(d);
+            Thermostat* th = dynamic_cast<Thermostat*>(d);
+            if (f) f->setThreshold(value);
+            if (th) th->setThreshold(value);
+            if ((f || th) && thresholds.setThreshold(d, value)) {
+                std::cout << "[System] " << d->getName() << " now reacts above " << value << ".\n";
+            } else {
+                std::cout << "[Error] Usage: threshold <value> <fan or thermostat name>\n";
+            }
+        }
+
+        else if (command.rfind("setpoint ", 0) == 0) {
+            // setpoint <temp> <thermostat name>
+            std::istringstream in(command.substr(9));
+            float target;
+            std::string name;
+            bool parsed = static_cast<bool>(in >> target);
+            std::getline(in >> std::ws, name);
+            Thermostat* th = parsed ? dynamic_cast<Thermostat*>(controller.findDevice(name)) : nullptr;
+            if (th) {
+                th->setSetpoint(target);
+                std::cout << "[System] " << th->getName() << " now holds " << target << "C.\n";
+            } else {
+                std::cout << "[Error] Usage: setpoint <temp> <thermostat name>\n";
+            }
+        }
+
+        else if (command.rfind("pid ", 0) == 0) {
+            // pid <kp> <ki> <kd> <thermostat name>
+            std::istringstream in(command.substr(4));
+            float kp, ki, kd;
+            std::string name;
+            bool parsed = static_cast<bool>(in >> kp >> ki >> kd);
+            std::getline(in >> std::ws, name);
+            Thermostat* th = parsed ? dynamic_cast<Thermostat*>(controller.findDevice(name)) : nullptr;
+            if (th) {
+                th->setGains(kp, ki, kd);
+                std::cout << "[System] " << th->getName() << " PID gains set to kp=" << kp << " ki=" << ki
+                          << " kd=" << kd << ".\n";
+            } else {
+                std::cout << "[Error] Usage: pid <kp> <ki> <kd> <thermostat name>\n";
+            }
+        }
+
+        else if (command.rfind("ramp ", 0) == 0 || command.rfind("fade ", 0) == 0) {
+            // ramp <speed-%> <duration> <fan name> | fade <brightness-%> <duration> <light name>
+            bool ramp = command[0] == 'r';
+            std::istringstream in(command.substr(5));
+            int level = -1;
+            std::string durationText, name;
+            SimTime duration = -1;
+            in >> level >> durationText;
+            std::getline(in >> std::ws, name);
+            SimClock::parseDuration(durationText, duration);
+            SmartDevice* d = controller.findDevice(name);
+            Fan* f = dynamic_cast<Fan*>(d);
+            Light* l = dynamic_cast<Light*>(d);
+            if (level < 0 || level > 100 || duration < 0 || (ramp ? !f : !l)) {
+                std::cout << "[Error] Usage: " << (ramp ? "ramp <speed-%> <duration> <fan name>"
+                                                        : "fade <brightness-%> <duration> <light name>") << "\n";
+            } else {
+                std::cout << "[Behavior] " << name << (ramp ? " ramping to " : " fading to ") << level
+                          << "% over " << SimClock::format(duration) << ".\n";
+                if (ramp) behaviors.start(rampFan(*f, level, duration), f, "fan ramp");
+                else behaviors.start(fadeLight(*l, level, duration), l, "light fade");
+            }
+        }
+
+        else if (command.rfind("preheat ", 0) == 0) {
+            // preheat <temp> <ramp duration> <hold duration> <thermostat name>
+            std::istringstream in(command.substr(8));
+            float target = 0.0f;
+            std::string rampText, holdText, name;
+            SimTime rampTime = -1, holdTime = -1;
+            bool ok = static_cast<bool>(in >> target >> rampText >> holdText);
+            std::getline(in >> std::ws, name);
+            ok = ok && SimClock::parseDuration(rampText, rampTime) && SimClock::parseDuration(holdText, holdTime)
+                    && rampTime >= 0 && holdTime >= 0;
+            Thermostat* th = dynamic_cast<Thermostat*>(controller.findDevice(name));
+            if (!ok || !th) {
+                std::cout << "[Error] Usage: preheat <temp> <ramp duration> <hold duration> <thermostat name>\n";
+            } else {
+                std::cout << "[Behavior] " << name << " pre-heating from " << th->getSetpoint() << "C to "
+                          << target << "C over " << SimClock::format(rampTime) << ".\n";
+                behaviors.start(preheat(*th, target, rampTime, holdTime), th, "pre-heat");
+            }
+        }
+
+        else if (command == "behaviors") {
+            behaviors.printBehaviors();
+        }
+
+        else if (command.rfind("behavior-stop ", 0) == 0) {
+            SmartDevice* d = controller.findDevice(command.substr(14));
+            if (d && behaviors.cancelDevice(d)) {
+                std::cout << "[Behavior] Stopped the behavior of " << d->getName() << ".\n";
+            } else {
+                std::cout << "[Error] No behavior is running on that device.\n";
+            }
+        }
+
+        else if (command == "thresholds") {
+            thresholds.printThresholds();
+        }
+
+        else if (command.rfind("rule ", 0) == 0) {
+            std::string error;
+            if (rules.addRule(command.substr(5), error)) {
+                std::cout << "[Rules] Rule " << rules.size() << " added.\n";
+            } else {
+                std::cout << "[Error] " << error << "\n";
+            }
+        }
+
+        else if (command.rfind("rules-load ", 0) == 0) {
+            int added = rules.loadFile(command.substr(11));
+            std::cout << "[Rules] " << added << " rules loaded (" << rules.size() << " total).\n";
+        }
+
+        else if (command == "rules") {
+            rules.printRules();
+        }
+
+        else if (command == "rules-clear") {
+            rules.clear();
+            std::cout << "[Rules] All rules removed.\n";
+        }
+
+        else if (command.rfind("zone ", 0) == 0) {
+            std::istringstream in(command.substr(5));
+            std::string name, parent = "home";
+            in >> name >> parent;
+            if (zones.addZone(name, parent)) {
+                std::cout << "[Zones] Zone \"" << name << "\" added under \"" << parent << "\".\n";
+            } else {
+                std::cout << "[Error] Zone name taken, or parent missing or a room.\n";
+            }
+        }
+
+        else if (command.rfind("assign ", 0) == 0) {
+            // assign <zone> <device name>
+            std::string rest = command.substr(7);
+            size_t space = rest.find(' ');
+            int zone = zones.find(rest.substr(0, space));
+            SmartDevice* d = space == std::string::npos ? nullptr : controller.findDevice(rest.substr(space + 1));
+            if (zone < 0 || !d) {
+                std::cout << "[Error] Usage: assign <zone> <device name>\n";
+            } else {
+                zones.assign(d, zone);
+                thermal.placeDevice(d, zone);
+                std::cout << "[Zones] " << d->getName() << " moved to \"" << rest.substr(0, space) << "\".\n";
+            }
+        }
+
+        else if (command == "zones") {
+            zones.printZones();
+        }
+
+        else if (command.rfind("thermal-add ", 0) == 0) {
+            // thermal-add <room> [start-temp]
+            std::istringstream in(command.substr(12));
+            std::string name;
+            float start = 20.0f;
+            in >> name >> start;
+            int zone = zones.find(name);
+            Sensor* s = zone < 0 || zones.level(zone) != ZoneManager::Level::Room
+                            ? nullptr : sensors.addSensor(name + "-temp", SensorKind::Temperature, false);
+            if (!s || !thermal.addRoom(zone, s, start)) {
+                std::cout << "[Error] Usage: thermal-add <room> [start-temp] (an unmodeled room)\n";
+            } else {
+                s->subscribe(&rules);
+                zones.members(zone).forEach([&](int id) {
+                    if (SmartDevice* d = controller.getDeviceById(id)) thermal.placeDevice(d, zone);
+                });
+                std::cout << "[Thermal] Modeling \"" << name << "\" from " << start << "C on sensor "
+                          << s->getId() << ".\n";
+            }
+        }
+
+        else if (command == "thermal") {
+            thermal.printRooms();
+        }
+
+        else if (command.rfind("outdoor ", 0) == 0) {
+            std::istringstream in(command.substr(8));
+            float t;
+            if (in >> t) {
+                thermal.setOutdoor(t);
+                std::cout << "[Thermal] Outdoor temperature set to " << t << "C.\n";
+            } else {
+                std::cout << "[Error] Usage: outdoor <temp>\n";
+            }
+        }
+
+        else if (command.rfind("on ", 0) == 0 || command.rfind("off ", 0) == 0) {
+            // on|off <zone> [type]
+            std::istringstream in(command);
+            std::string state, zoneName, typeName;
+            in >> state >> zoneName >> typeName;
+            int zone = zones.find(zoneName);
+            const DeviceSet* type = typeName.empty() ? nullptr : controller.devicesOfType(typeName);
+            if (zone < 0) {
+                std::cout << "[Error] Unknown zone \"" << zoneName << "\".\n";
+            } else if (!typeName.empty() && !type) {
+                std::cout << "[Error] No devices of type \"" << typeName << "\".\n";
+            } else {
+                int changed = zones.apply(zone, type, state == "on");
+                std::cout << "[Zones] " << changed << " devices switched " << state << ".\n";
+            }
+        }
+
+        else if (command.rfind("scene-save ", 0) == 0) {
+            std::istringstream in(command.substr(11));
+            std::string name, zoneName = "home";
+            in >> name >> zoneName;
+            int zone = zones.find(zoneName);
+            if (name.empty() || zone < 0) {
+                std::cout << "[Error] Usage: scene-save <name> [zone]\n";
+            } else {
+                scenes.capture(name, zones.members(zone));
+                std::cout << "[Scenes] Scene \"" << name << "\" saved from \"" << zoneName << "\".\n";
+            }
+        }
+
+        else if (command.rfind("scene-set ", 0) == 0) {
+            // scene-set <name> <on|off> <device name>
+            std::istringstream in(command.substr(10));
+            std::string name, state, deviceName;
+            in >> name >> state;
+            std::getline(in >> std::ws, deviceName);
+            SmartDevice* d = controller.findDevice(deviceName);
+            if (!d || (state != "on" && state != "off")) {
+                std::cout << "[Error] Usage: scene-set <name> <on|off> <device name>\n";
+            } else {
+                scenes.setTarget(name, d, state == "on");
+                std::cout << "[Scenes] " << d->getName() << " set " << state << " in \"" << name << "\".\n";
+            }
+        }
+
+        else if (command.rfind("scene ", 0) == 0) {
+            const SceneManager::Scene* scene = scenes.find(command.substr(6));
+            if (!scene) {
+                std::cout << "[Error] Unknown scene \"" << command.substr(6) << "\".\n";
+            } else {
+                SceneManager::Activation a = scenes.activate(*scene);
+                std::cout << "[Scenes] \"" << scene->name << "\" activated: " << a.changed
+                          << " devices changed in " << a.microseconds << " us.\n";
+            }
+        }
+
+        else if (command == "scenes") {
+            scenes.printScenes();
+        }
+
+        else if (command == "sensors") {
+            sensors.listSensors();
+        }
+
+        else if (command.rfind("add-sensor ", 0) == 0) {
+            std::istringstream in(command.substr(11));
+            std::string id, kindName;
+            in >> id >> kindName;
+            SensorKind kind;
+            if (!parseSensorKind(kindName, kind)) {
+                std::cout << "[Error] Sensor kind must be temperature, humidity, motion or light.\n";
+            } else if (!sensors.addSensor(id, kind)) {
+                std::cout << "[Error] Sensor \"" << id << "\" already exists.\n";
+            } else {
+                std::cout << "[System] " << kindName << " sensor \"" << id << "\" added.\n";
+            }
+        }
+
+        else if (command.rfind("subscribe ", 0) == 0) {
+            // subscribe <sensor-id|kind> <device name>
+            std::string rest = command.substr(10);
+            size_t space = rest.find(' ');
+            std::string source = rest.substr(0, space);
+            SmartDevice* d = space == std::string::npos ? nullptr : controller.findDevice(rest.substr(space + 1));
+            SensorKind kind;
+            if (!d) {
+                std::cout << "[Error] Unknown device.\n";
+            } else if (parseSensorKind(source, kind)) {
+                sensors.subscribeKind(kind, d);
+                std::cout << "[System] " << d->getName() << " subscribed to all " << source << " sensors.\n";
+            } else if (sensors.subscribe(source, d)) {
+                std::cout << "[System] " << d->getName() << " subscribed to sensor \"" << source << "\".\n";
+            } else {
+                std::cout << "[Error] Unknown sensor or kind \"" << source << "\".\n";
+            }
         }
 
         else if (command == "logs") {
             logger->printLogs();
         }
 
+        else if (command.rfind("logs ", 0) == 0) {
+            // logs <device|type> [--from <t>] [--to <t>]; the name is everything before the first flag
+            size_t flags = command.find(" --", 4);
+            std::string target = command.substr(5, flags == std::string::npos ? std::string::npos : flags - 5);
+            SimTime from = std::numeric_limits<SimTime>::min(), to = std::numeric_limits<SimTime>::max();
+            std::istringstream in(flags == std::string::npos ? std::string() : command.substr(flags));
+            std::string flag, text;
+            bool valid = true;
+            while (valid && in >> flag) {
+                valid = (flag == "--from" || flag == "--to") && in >> text
+                        && SimClock::parseDuration(text, flag == "--from" ? from : to);
+            }
+            if (!valid) {
+                std::cout << "[Error] Usage: logs <device|type> [--from <time>] [--to <time>]\n";
+                return true;
+            }
+            logger->printQuery(target, from, to);
+        }
+
+        else if (command == "stats") {
+            rollup.printStats();
+        }
+
+        else if (command == "energy" || command.rfind("energy ", 0) == 0) {
+            const EnergyMeter& energy = SmartDevice::getEnergyMeter();
+            std::string target = command.size() > 7 ? command.substr(7) : "home";
+            int zone = zones.find(target);
+            SmartDevice* d = zone < 0 ? controller.findDevice(target) : nullptr;
+            if (zone >= 0) {
+                const EnergyMeter::Totals& t = zone == 0 ? energy.homeTotals() : energy.zone(zone);
+                EnergyMeter::printTotal(target, t.energyAt(currentTime), t.power);
+            } else if (d) {
+                EnergyMeter::printTotal(d->getName(), energy.deviceEnergy(d->getId(), currentTime),
+                                        energy.devicePower(d->getId()));
+            } else {
+                std::cout << "[Error] Unknown zone or device \"" << target << "\".\n";
+            }
+        }
+
+        else if (command == "energy-report") {
+            SmartDevice::getEnergyMeter().printReport(currentTime);
+        }
+
+        else if (command.rfind("watts ", 0) == 0) {
+            // watts <W> <device name|type>
+            std::istringstream in(command.substr(6));
+            double w = -1;
+            std::string target;
+            in >> w;
+            std::getline(in >> std::ws, target);
+            EnergyMeter& energy = SmartDevice::getEnergyMeter();
+            SmartDevice* d = controller.findDevice(target);
+            if (w < 0 || target.empty()) {
+                std::cout << "[Error] Usage: watts <W> <device|type>\n";
+            } else if (d) {
+                if (energy.needsDevice(d->getId())) energy.addDevice(d->getId(), d->getType(), d->getName());
+                energy.setDeviceWatts(d->getId(), w, currentTime);
+                std::cout << "[Energy] " << d->getName() << " rated at " << w << " W.\n";
+            } else if (energy.hasType(target)) {
+                int n = energy.setTypeWatts(target, w, currentTime);
+                std::cout << "[Energy] " << target << " devices rated at " << w << " W (" << n << " updated).\n";
+            } else {
+                std::cout << "[Error] Unknown device or type \"" << target << "\".\n";
+            }
+        }
+
+        else if (command == "notify-stats") {
+            SmartDevice::printNotificationStats();
+        }
+
+        else if (command == "wal") {
+            wal.printStats();
+        }
+
+        else if (command.rfind("wal-window ", 0) == 0) {
+            try {
+                size_t used;
+                long long window = std::stoll(command.substr(11), &used);
+                if (window < 0 || command.find_first_not_of(' ', 11 + used) != std::string::npos) {
+                    throw std::invalid_argument("wal-window");
+                }
+                wal.setBatchWindow(window);
+                std::cout << "[WAL] Group commit window set to " << wal.getBatchWindow() << " us.\n";
+            } catch (const std::exception&) {
+                std::cout << "[Error] Usage: wal-window <microseconds>\n";
+            }
+        }
+
+        else if (command == "checkpoint") {
+            wal.checkpoint(controller.getAllDevices());
+        }
+
         else if (command == "list") {
             controller.listDevices();
         }
 
         else if (command == "schedule") {
-            std::string deviceName, state, strategyType;
-            int timeValue;
+            std::string deviceName, state, strategyType, timeText;
+            SimTime timeValue;
             std::cout << "Enter device name: ";
-            std::getline(std::cin, deviceName);
+            std::getline(input, deviceName);
             std::cout << "Enter desired state (on/off): ";
-            std::getline(std::cin, state);
-            std::cout << "Choose strategy (one-time / periodic / delayed): ";
-            std::getline(std::cin, strategyType);
-            std::cout << "Enter time value (in seconds): ";
-            std::cin >> timeValue;
-            std::cin.ignore();
+            std::getline(input, state);
+            std::cout << "Choose strategy (one-time / periodic / delayed / cron): ";
+            std::getline(input, strategyType);
 
             SchedulingStrategy* strategy = nullptr;
+            if (strategyType == "cron") {
+                std::string expr, error;
+                std::cout << "Enter cron expression (minute hour day month weekday, e.g. 0 7 * * mon-fri): ";
+                std::getline(input, expr);
+                strategy = CronSchedule::compile(expr, error);
+                if (!strategy) {
+                    std::cout << "[Error] " << error << "\n";
+                    return true;
+                }
+                SimTime next = strategy->nextFireTime(currentTime);
+                Scheduler::TaskId id = scheduler.addTask(deviceName, state == "on", strategy);
+                if (next == SchedulingStrategy::NEVER) {
+                    std::cout << "[Error] The expression never matches a date.\n";
+                } else if (id != Scheduler::INVALID_TASK) {
+                    int64_t sec = SimClock::wholeSeconds(next);
+                    std::cout << "[Scheduler] Task " << id << " added; next run at t=" << SimClock::format(next)
+                              << " (day " << sec / 86400 << ", " << sec % 86400 / 3600 << ":"
+                              << (sec % 3600 / 60 < 10 ? "0" : "") << sec % 3600 / 60 << ").\n";
+                }
+                return true;
+            }
+
+            std::cout << "Enter time value (seconds, e.g. 5, 0.1, 250ms, 10m): ";
+            std::getline(input, timeText);
+            if (!SimClock::parseDuration(timeText, timeValue)) {
+                std::cout << "[Error] Invalid time value.\n";
+                return true;
+            }
+
             if (strategyType == "one-time")
                 strategy = new OneTimeSchedule(timeValue);
-            else if (strategyType == "periodic")
+            else if (strategyType == "periodic" && timeValue > 0)
                 strategy = new PeriodicSchedule(timeValue);
             else if (strategyType == "delayed")
                 strategy = new DelayedSchedule(currentTime + timeValue);
             else {
                 std::cout << "[Error] Invalid strategy type.\n";
-                continue;
+                return true;
+            }
+            SimTime next = strategy->nextFireTime(currentTime);
+            Scheduler::TaskId id = scheduler.addTask(deviceName, state == "on", strategy);
+            if (next == SchedulingStrategy::NEVER) {
+                std::cout << "[Error] That time has already passed.\n";
+            } else if (id != Scheduler::INVALID_TASK) {
+                std::cout << "[Scheduler] Task " << id << " added.\n";
+            }
+        }
+
+        else if (command.rfind("schedule-import ", 0) == 0) {
+            std::string path = command.substr(16);
+            ScheduleImporter importer(controller, scheduler);
+            ScheduleImporter::printResult(path, importer.import(path));
+        }
+
+        else if (command == "schedules") {
+            scheduler.printTasks();
+        }
+
+        else if (command.rfind("schedule-policy ", 0) == 0) {
+            Scheduler::ConflictPolicy policy;
+            if (Scheduler::parsePolicy(command.substr(16), policy)) {
+                scheduler.setConflictPolicy(policy);
+                std::cout << "[Scheduler] Conflict policy set to " << Scheduler::policyName(policy) << ".\n";
+            } else {
+                std::cout << "[Error] Usage: schedule-policy <warn|keep-first|keep-last>\n";
+            }
+        }
+
+        else if (command == "conflicts") {
+            scheduler.printConflicts();
+        }
+
+        else if (command.rfind("unschedule ", 0) == 0) {
+            try {
+                if (scheduler.cancel(std::stoull(command.substr(11)))) {
+                    std::cout << "[Scheduler] Task cancelled.\n";
+                } else {
+                    std::cout << "[Error] No pending task with that ID.\n";
+                }
+            } catch (const std::exception&) {
+                std::cout << "[Error] Usage: unschedule <task-id>\n";
             }
-            scheduler.addTask(deviceName, state == "on", strategy);
         }
 
         else if (command == "tick") {
-            currentTime++;
-            std::cout << "[Tick] Simulated time: " << currentTime << "s\n";
-            scheduler.update(currentTime);
+            std::cout << "[Tick] Simulated time: " << SimClock::format(currentTime + SimClock::SECOND) << "\n";
+            advanceTo(currentTime + SimClock::SECOND);
+        }
+
+        else if (command.rfind("advance ", 0) == 0) {
+            SimTime duration;
+            if (!SimClock::parseDuration(command.substr(8), duration) || duration < 0) {
+                std::cout << "[Error] Usage: advance <duration> (e.g., 0.25, 500ms, 10m, 7d)\n";
+                return true;
+            }
+            auto begin = std::chrono::steady_clock::now();
+            advanceTo(currentTime + duration);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            std::cout << "[Advance] Simulated time: " << SimClock::format(currentTime) << " ("
+                      << seconds * 1000.0 << " ms)\n";
         }
 
         else if (command == "reset") {
+            SmartDevice::getEnergyMeter().rebase(currentTime, 0);
             currentTime = 0;
+            SimClock::set(currentTime);
             scheduler.clearTasks();
+            behaviors.cancelAll();
+            thermal.restart(currentTime);
+            rollup.restart(currentTime);
             std::cout << "[System] Simulation reset.\n";
         }
 
+        else if (command == "server-stats") {
+            if (server) server->printStats();
+            else std::cout << "[Error] Not running as a server (start with --unix <path>, --tcp <port> or their --binary- forms).\n";
+        }
+
         else {
             controller.toggleDevice(command);
         }
+        return true;
+    };
+
+    if (!unixPath.empty() || tcpPort > 0 || !binaryUnixPath.empty() || binaryTcpPort > 0) {
+        // Server mode: one epoll loop serves every client. On text listeners each
+        // complete line is a command (follow-up lines of add/sensor/schedule must
+        // arrive with it); its output is the reply, terminated by a line "END".
+        // Binary listeners take frames of operations on device handles (see
+        // BinaryProtocol). The changes of one wakeup are made durable with one
+        // WAL sync before any reply is sent.
+        ControlServer control;
+        std::string error;
+        if ((!unixPath.empty() && !control.listenUnix(unixPath, error))
+            || (tcpPort > 0 && !control.listenTcp(tcpPort, error))
+            || (!binaryUnixPath.empty() && !control.listenUnix(binaryUnixPath, error, true))
+            || (binaryTcpPort > 0 && !control.listenTcp(binaryTcpPort, error, true))) {
+            std::cerr << "[Server] Cannot listen: " << error << "\n";
+            return 1;
+        }
+        server = &control;
+        BinaryProtocol binary(controller, scheduler, BinaryProtocol::Hooks{
+            wireDevice,
+            settle,
+            [&](SimTime duration) {
+                advanceTo(currentTime + duration);
+                return currentTime;
+            }});
+        std::cout << "[Server] Listening" << (unixPath.empty() ? "" : " on " + unixPath)
+                  << (tcpPort > 0 ? " on 127.0.0.1:" + std::to_string(tcpPort) : "")
+                  << (binaryUnixPath.empty() ? "" : " on " + binaryUnixPath + " (binary)")
+                  << (binaryTcpPort > 0 ? " on 127.0.0.1:" + std::to_string(binaryTcpPort) + " (binary)" : "")
+                  << std::endl;
+        std::string discarded;
+        control.run([&](ControlServer::Batch& batch) {
+            if (batch.binary) {
+                // Binary clients only get results; console output of their operations is dropped
+                ControlServer::OutputCapture capture(std::cout, discarded);
+                binary.handle(batch);
+                discarded.clear();
+                return;
+            }
+            size_t end = batch.input.rfind('\n');
+            if (end == std::string_view::npos) return;
+            std::istringstream input{std::string(batch.input.substr(0, end + 1))};
+            ControlServer::OutputCapture capture(std::cout, *batch.output);
+            std::string command;
+            while (std::getline(input, command)) {
+                if (!command.empty() && command.back() == '\r') command.pop_back();
+                batch.commands++;
+                if (!execute(command, input)) {
+                    batch.close = true;
+                    break;
+                }
+                if (input.fail() && !input.eof()) input.clear();  // Keep serving the following commands
+                settle();
+                std::cout << "END\n";
+            }
+            batch.consumed = end + 1;
+        }, [&]() { return wal.sync(); });
+        server = nullptr;
+        std::cout << "[Server] Stopped.\n";
+        control.printStats();
+    } else {
+        // CLI Loop
+        std::string command;
+        while (true) {
+            settle();
+            // Everything acknowledged so far is durable before we prompt again
+            if (!wal.sync()) std::cout << "[WAL] Warning: the last changes are not durable yet.\n";
+            printMenu();
+            std::cout << "\nEnter command : ";
+            if (!std::getline(std::cin, command) || !execute(command, std::cin)) break;
+        }
     }
 
+    SmartDevice::endNotificationBatch();
     delete logger;
     return 0;
 }
@@ -3,8 +3,8 @@
  * @brief Concrete implementation of a smart fan device in SmartHomeSim.
  *
  * The `Fan` class inherits from `SmartDevice` and implements logic to respond to
- * environmental sensor input. When the temperature exceeds a threshold (28°C), 
- * the fan turns ON; otherwise, it turns OFF.
+ * environmental sensor input. When the temperature exceeds its threshold (28°C by
+ * default, configurable per fan), the fan turns ON; otherwise, it turns OFF.
  *
  * Key Features:
  * - Implements `getType()` for device identification
@@ -22,6 +22,9 @@
 #include "SmartDevice.h"
 
 class Fan : public SmartDevice {
+    float threshold = 28.0f;  ///< Temperature above which the fan turns ON
+    int speed = 100;          ///< Speed in percent while ON
+
 public:
     /**
      * @brief Constructs a smart fan with a given name.
@@ -35,10 +38,48 @@ public:
      */
     std::string getType() const override { return "Fan"; }
 
+    /**
+     * @brief Gets the temperature threshold.
+     */
+    float getThreshold() const { return threshold; }
+
+    /**
+     * @brief Sets the temperature threshold.
+     * @param t Temperature above which the fan turns ON
+     */
+    void setThreshold(float t) { threshold = t; }
+
+    /**
+     * @brief Gets the speed in percent (the speed used while the fan is ON).
+     */
+    int getSpeed() const { return speed; }
+
+    /**
+     * @brief Sets the speed; 0 turns the fan OFF and any other speed turns it ON.
+     * @param percent Speed from 0 to 100
+     */
+    void setSpeed(int percent) {
+        percent = percent < 0 ? 0 : percent > 100 ? 100 : percent;
+        if (percent > 0) speed = percent;
+        setState(percent > 0);
+    }
+
+    /**
+     * @brief Turns the fan ON when the temperature rises above its threshold
+     * and OFF when it falls back below.
+     * @param above true if the reading is now above the threshold
+     */
+    void onThresholdCrossed(bool above) override;
+
+    /**
+     * @brief A fan's threshold reaction is ON above, OFF below.
+     */
+    bool thresholdSwitchesPower() const override { return true; }
+
     /**
      * @brief Responds to sensor input (e.g., temperature).
      * 
-     * Turns the fan ON if the temperature exceeds 28°C,
+     * Turns the fan ON if the temperature exceeds the threshold,
      * and turns it OFF otherwise.
      * 
      * @param value The value received from the sensor (e.g., temperature)
@@ -49,10 +90,14 @@ public:
 /**
  * @brief Inline implementation of the sensor-trigger response for Fan.
  * 
- * Turns ON if temperature > 28, OFF otherwise.
+ * Turns ON if temperature > threshold, OFF otherwise.
  */
 inline void Fan::onSensorTriggered(int value) {
-    if (value > 28) {
+    onThresholdCrossed(value > threshold);
+}
+
+inline void Fan::onThresholdCrossed(bool above) {
+    if (above) {
         std::cout << "[Fan] " << getName() << " is turning ON due to high temperature.\n";
         setState(true);
     } else {
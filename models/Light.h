@@ -22,6 +22,8 @@
 #include "SmartDevice.h"
 
 class Light : public SmartDevice {
+    int brightness = 100;  ///< Brightness in percent while ON
+
 public:
     /**
      * @brief Constructs a smart light with the given name.
@@ -35,6 +37,21 @@ public:
      */
     std::string getType() const override { return "Light"; }
 
+    /**
+     * @brief Gets the brightness in percent (the brightness used while the light is ON).
+     */
+    int getBrightness() const { return brightness; }
+
+    /**
+     * @brief Sets the brightness; 0 turns the light OFF and any other value turns it ON.
+     * @param percent Brightness from 0 to 100
+     */
+    void setBrightness(int percent) {
+        percent = percent < 0 ? 0 : percent > 100 ? 100 : percent;
+        if (percent > 0) brightness = percent;
+        setState(percent > 0);
+    }
+
     /**
      * @brief Handles sensor input (no behavior defined currently).
      * Logs that the light received the update but takes no action.
@@ -8,8 +8,11 @@
  *
  * Key Features:
  * - Implements the Subject role in the Observer pattern
- * - Allows attaching observers (e.g., loggers)
+ * - Allows attaching observers (e.g., loggers) through the shared `SubscriptionTable`
  * - Provides toggle and setState functionality with automatic notifications
+ * - Supports a deferred-notification mode that coalesces changes into one delivery per batch
+ * - Maintains a bitset of the handles of all devices that are currently on
+ * - Books energy on every on/off transition in the shared `EnergyMeter`
  * - Requires derived classes to implement sensor-trigger behavior and device type identification
  *
  * Design Patterns:
@@ -22,20 +25,58 @@
 
 #include <string>
 #include <vector>
+#include <iostream>
 #include "../observers/Observer.h"
+#include "../observers/SubscriptionTable.h"
+#include "sensor/SensorListener.h"
+#include "../utils/DeviceSet.h"
+#include "../utils/EnergyMeter.h"
+#include "../utils/SimClock.h"
 
-class SmartDevice {
+/**
+ * @brief Counters describing how many notifications deferred mode saved.
+ */
+struct NotificationStats {
+    long long requested = 0;      ///< State changes that asked to notify
+    long long coalesced = 0;      ///< Repeat changes of an already-dirty device
+    long long cancelled = 0;      ///< Dirty devices whose final state equals the initial one
+    long long delivered = 0;      ///< Device notifications actually delivered
+    long long observerCalls = 0;  ///< Observer invocations (one per observer per batch)
+    long long batches = 0;        ///< Flushes that delivered at least one change
+};
+
+class SmartDevice : public SensorListener {
 protected:
     std::string name;                     ///< Name of the device (e.g., "LivingRoom Light")
+    int id;                               ///< Dense numeric handle assigned at construction
     bool isOn;                            ///< Current state of the device (true = on, false = off)
-    std::vector<Observer*> observers;     ///< List of attached observers
+    bool dirty = false;                   ///< Queued for delivery at the end of the batch
+    bool stateBeforeBatch = false;        ///< State before the first change in the batch
+
+    static inline int nextId = 0;         ///< Next handle to hand out
+    static inline int batchDepth = 0;     ///< Nesting depth of open notification batches
+    static inline std::vector<SmartDevice*> dirtyDevices;  ///< Devices changed in the open batch
+    static inline NotificationStats stats;                ///< Deferred-mode counters
+    static inline DeviceSet onDevices;                    ///< Handles of devices that are on
+    static inline EnergyMeter energy;                     ///< Energy totals of all devices
+
+    /**
+     * @brief Writes the on/off state and keeps the global state bitset and the
+     * energy totals in sync.
+     */
+    void writeState(bool on) {
+        isOn = on;
+        onDevices.assign(id, on);
+        if (energy.needsDevice(id)) energy.addDevice(id, getType(), name);
+        energy.setState(id, on, SimClock::now());
+    }
 
 public:
     /**
      * @brief Constructor that initializes device with a given name and default state off.
      * @param deviceName Name of the smart device
      */
-    SmartDevice(const std::string& deviceName) : name(deviceName), isOn(false) {}
+    SmartDevice(const std::string& deviceName) : name(deviceName), id(nextId++), isOn(false) {}
 
     /**
      * @brief Virtual destructor to allow proper cleanup in derived classes.
@@ -49,11 +90,40 @@ public:
      */
     virtual void onSensorTriggered(int sensorValue) = 0;
 
+    /**
+     * @brief Receives a typed reading from a subscribed sensor.
+     *
+     * By default temperature readings are forwarded to onSensorTriggered(int) and
+     * other kinds are ignored; devices reacting to humidity, motion or light
+     * level override this.
+     *
+     * @param reading The published reading
+     */
+    void onSensorReading(const SensorReading& reading) override {
+        if (reading.kind == SensorKind::Temperature) onSensorTriggered(reading.asInt());
+    }
+
+    /**
+     * @brief Reacts to a reading crossing this device's threshold (see ThresholdEvaluator).
+     *
+     * Only called when the above/below state actually flips. Devices without a
+     * threshold reaction ignore it.
+     *
+     * @param above true if the reading is now above the threshold
+     */
+    virtual void onThresholdCrossed(bool) {}
+
+    /**
+     * @brief Returns whether onThresholdCrossed() switches the device ON above
+     * the threshold and OFF below it (rather than, e.g., changing a mode).
+     */
+    virtual bool thresholdSwitchesPower() const { return false; }
+
     /**
      * @brief Toggles the device's on/off state and notifies observers of the change.
      */
     virtual void toggle() {
-        isOn = !isOn;
+        writeState(!isOn);
         notify();
     }
 
@@ -63,17 +133,119 @@ public:
      */
     void setState(bool on) {
         if (isOn != on) {
-            isOn = on;
+            writeState(on);
             notify();
         }
     }
 
+    /**
+     * @brief Restores a persisted on/off state without notifying observers.
+     *
+     * Used by crash recovery to rebuild device state from the write-ahead log;
+     * the transitions being replayed were already observed before the restart.
+     *
+     * @param on Recovered state (true for on, false for off)
+     */
+    void restoreState(bool on) { writeState(on); }
+
     /**
      * @brief Notifies all registered observers that the device state has changed.
+     *
+     * Inside a notification batch the device is only marked dirty; observers are
+     * called once with its final state when the batch is flushed.
      */
     void notify() {
-        for (auto* o : observers)
-            o->update(this);
+        stats.requested++;
+        SubscriptionTable& table = SubscriptionTable::instance();
+        if (table.needsType(id)) table.setDeviceType(id, getType());
+        if (batchDepth > 0) {
+            if (dirty) {
+                stats.coalesced++;
+            } else {
+                dirty = true;
+                stateBeforeBatch = !isOn;  // notify() always follows a state flip
+                dirtyDevices.push_back(this);
+            }
+            return;
+        }
+        stats.delivered++;
+        stats.observerCalls += table.publish(id, this);
+    }
+
+    /**
+     * @brief Opens a (possibly nested) notification batch.
+     * Changes made until the matching endNotificationBatch() are coalesced.
+     */
+    static void beginNotificationBatch() { batchDepth++; }
+
+    /**
+     * @brief Closes a notification batch, flushing when the outermost one ends.
+     */
+    static void endNotificationBatch() {
+        if (batchDepth > 0 && --batchDepth == 0) flushNotifications();
+    }
+
+    /**
+     * @brief Delivers all pending changes now (e.g., at the end of a tick).
+     *
+     * Devices whose final state equals their state before the batch are dropped.
+     * Every observer then receives one updateBatch() call with the devices it
+     * observes, in the order they first changed.
+     */
+    static void flushNotifications() {
+        if (dirtyDevices.empty()) return;
+        std::vector<SmartDevice*> pending;
+        pending.swap(dirtyDevices);  // Observers may start a new round while we deliver
+
+        std::vector<SmartDevice*> changed;
+        std::vector<int> ids;
+        for (auto* d : pending) {
+            d->dirty = false;
+            if (d->isOn == d->stateBeforeBatch) {
+                stats.cancelled++;
+                continue;
+            }
+            changed.push_back(d);
+            ids.push_back(d->id);
+        }
+        if (changed.empty()) return;
+
+        stats.delivered += static_cast<long long>(changed.size());
+        stats.observerCalls += SubscriptionTable::instance().publishBatch(changed, ids);
+        stats.batches++;
+    }
+
+    /**
+     * @brief Returns the handles of all devices that are currently on.
+     */
+    static const DeviceSet& getOnDevices() { return onDevices; }
+
+    /**
+     * @brief Returns the energy meter shared by all devices.
+     */
+    static EnergyMeter& getEnergyMeter() { return energy; }
+
+    /**
+     * @brief Returns whether changes are waiting for the next flush.
+     */
+    static bool hasPendingNotifications() { return !dirtyDevices.empty(); }
+
+    /**
+     * @brief Returns the deferred-notification counters.
+     */
+    static const NotificationStats& getNotificationStats() { return stats; }
+
+    /**
+     * @brief Prints how many notifications deferred mode delivered and saved.
+     */
+    static void printNotificationStats() {
+        std::cout << "\n===== Notification Stats =====\n";
+        std::cout << "State changes:         " << stats.requested << "\n";
+        std::cout << "Delivered:             " << stats.delivered << "\n";
+        std::cout << "Saved (coalesced):     " << stats.coalesced << "\n";
+        std::cout << "Saved (no net change): " << stats.cancelled << "\n";
+        std::cout << "Observer calls:        " << stats.observerCalls << " in " << stats.batches << " batches\n";
+        std::cout << "==============================\n";
     }
 
     /**
@@ -88,6 +260,16 @@ public:
      */
     std::string getName() const { return name; }
 
+    /**
+     * @brief Gets the device's numeric handle.
+     *
+     * Handles are dense (0, 1, 2, ...) in creation order, so they can index
+     * per-device arrays in observers and controllers.
+     *
+     * @return The device handle
+     */
+    int getId() const { return id; }
+
     /**
      * @brief Gets the current on/off state of the device.
      * @return True if the device is on, false otherwise
@@ -96,9 +278,13 @@ public:
 
     /**
      * @brief Attaches an observer to this device for state change notifications.
+     *
+     * To observe every device, or every device of a type, subscribe once through
+     * SubscriptionTable::subscribeAll / subscribeType instead.
+     *
      * @param o Pointer to an Observer instance
      */
-    void attach(Observer* o) { observers.push_back(o); }
+    void attach(Observer* o) { SubscriptionTable::instance().subscribe(id, o); }
 };
 
 #endif // SMART_DEVICE_H
@@ -11,6 +11,10 @@
  * - Implements the Strategy Pattern using TemperatureStrategy interface
  * - Uses Observer Pattern to respond to sensor value changes
  *
+ * Each thermostat owns a PID controller slot in the shared `PidBank`; the
+ * setpoint and the current mode's power limit are written into it on change,
+ * and all controllers are stepped together (see `ThermalModel`).
+ *
  * Key Features:
  * - Dynamically switches behavior strategy based on sensor input
  * - Applies selected strategy only when the device is toggled on
@@ -24,44 +28,105 @@
 #include "strategies/TemperatureStrategy.h"
 #include "strategies/EcoMode.h"
 #include "strategies/ComfortMode.h"
+#include "../utils/PidBank.h"
 
 class Thermostat : public SmartDevice {
     TemperatureStrategy* strategy = nullptr;  ///< Pointer to current strategy instance
+    float threshold = 28.0f;                  ///< Temperature above which Comfort Mode is used
+    float setpoint = 21.0f;                   ///< Target temperature while ON
+    int pid;                                  ///< Controller slot in the shared bank
+
+    static inline PidBank controllers;        ///< PID state of all thermostats
 
 public:
     /**
      * @brief Constructs a Thermostat with the given name.
      * @param name The name of the thermostat device
      */
-    Thermostat(const std::string& name) : SmartDevice(name) {}
+    Thermostat(const std::string& name) : SmartDevice(name), pid(controllers.add(setpoint)) {}
+
+    /**
+     * @brief Returns the PID controllers of all thermostats.
+     */
+    static PidBank& getControllers() { return controllers; }
+
+    /**
+     * @brief Returns this thermostat's controller slot.
+     */
+    int getPid() const { return pid; }
+
+    /**
+     * @brief Returns the controller output: heating (positive) or cooling
+     * (negative) power as a fraction of full power.
+     */
+    float getDemand() const { return controllers.getOutput(pid); }
+
+    /**
+     * @brief Sets the PID gains of this thermostat.
+     */
+    void setGains(float kp, float ki, float kd) { controllers.setGains(pid, kp, ki, kd); }
 
     /**
      * @brief Reacts to sensor input (e.g., temperature) by switching strategy.
      * 
-     * If temperature exceeds 28, it switches to ComfortMode.
+     * If temperature exceeds the threshold, it switches to ComfortMode.
      * Otherwise, it stays or switches to EcoMode.
-     * Previous strategy is deleted to prevent memory leaks.
      * 
      * @param value The sensor value (e.g., temperature reading)
      */
     void onSensorTriggered(int value) override {
+        onThresholdCrossed(value > threshold);
+    }
+
+    /**
+     * @brief Switches strategy when the temperature crosses the threshold.
+     * Previous strategy is deleted to prevent memory leaks.
+     * @param above true if the reading is now above the threshold
+     */
+    void onThresholdCrossed(bool above) override {
         std::cout << "[Thermostat] " << getName() << " responding to sensor change...";
 
         // Dynamically select strategy based on temperature threshold
         delete strategy; // Prevent memory leak by deleting current strategy
 
-        if (value > 28) {
+        if (above) {
             std::cout << "  Switching to Comfort Mode.\n";
             strategy = new ComfortMode();
         } else {
             std::cout << "  Staying in Eco Mode.\n";
             strategy = new EcoMode();
         }
+        controllers.setLimit(pid, strategy->output());
 
         // Strategy can be applied immediately or deferred based on state
         // applyTemperatureStrategy();
     }
 
+    /**
+     * @brief Gets the temperature threshold.
+     */
+    float getThreshold() const { return threshold; }
+
+    /**
+     * @brief Sets the temperature threshold.
+     * @param t Temperature above which Comfort Mode is used
+     */
+    void setThreshold(float t) { threshold = t; }
+
+    /**
+     * @brief Gets the target temperature.
+     */
+    float getSetpoint() const { return setpoint; }
+
+    /**
+     * @brief Sets the target temperature.
+     * @param t Target temperature in degrees Celsius
+     */
+    void setSetpoint(float t) {
+        setpoint = t;
+        controllers.setSetpoint(pid, t);
+    }
+
     /**
      * @brief Applies the current temperature strategy if one is set.
      * Can be triggered after toggling or sensor update.
@@ -84,6 +149,7 @@ public:
      */
     void setStrategy(TemperatureStrategy* s) {
         strategy = s;
+        controllers.setLimit(pid, s ? s->output() : 1.0f);
     }
 
     /**
@@ -101,6 +167,7 @@ public:
      */
     ~Thermostat() override {
         delete strategy;
+        controllers.release(pid);
     }
 };
 
@@ -0,0 +1,99 @@
+/**
+ * @file DeviceBehaviors.h
+ * @brief Multi-step device behaviors written as coroutines.
+ *
+ * Each function returns a `Behavior` that `BehaviorRuntime::start()` runs on
+ * simulated time. A behavior changes its device a step at a time and suspends
+ * between steps, so it needs no thread and costs nothing while it waits.
+ *
+ * - rampFan: moves a fan's speed linearly to a target over a duration
+ * - fadeLight: moves a light's brightness linearly to a target over a duration
+ * - preheat: raises a thermostat's setpoint over a ramp time, holds it, then restores it
+ *
+ * Ramps and fades take one step per percent of change, evenly spaced over the
+ * duration so the last step lands exactly at its end; a target of 0 switches
+ * the device OFF there.
+ *
+ * Responsibilities:
+ * - Describe the step sequence of each behavior
+ * - Report when a behavior completes
+ */
+
+#ifndef DEVICE_BEHAVIORS_H
+#define DEVICE_BEHAVIORS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include "../Fan.h"
+#include "../Light.h"
+#include "../Thermostat.h"
+#include "../../controllers/BehaviorRuntime.h"
+#include "../../utils/SimClock.h"
+
+/**
+ * @brief Ramps a fan's speed to `target` percent over `duration`.
+ *
+ * An OFF fan starts from 0%, so ramping it up switches it ON at the first step.
+ */
+inline Behavior rampFan(Fan& fan, int target, SimTime duration) {
+    SimTime start = SimClock::now();
+    int from = fan.getState() ? fan.getSpeed() : 0;
+    int steps = std::abs(target - from);
+    for (int i = 1; i <= steps; ++i) {
+        co_await sleepUntil(start + duration * i / steps);
+        fan.setSpeed(from + (target > from ? i : -i));
+    }
+    fan.setSpeed(target);
+    std::cout << "[Behavior] " << fan.getName() << " reached " << target << "% speed at t="
+              << SimClock::format(SimClock::now()) << ".\n";
+}
+
+/**
+ * @brief Fades a light's brightness to `target` percent over `duration`.
+ */
+inline Behavior fadeLight(Light& light, int target, SimTime duration) {
+    SimTime start = SimClock::now();
+    int from = light.getState() ? light.getBrightness() : 0;
+    int steps = std::abs(target - from);
+    for (int i = 1; i <= steps; ++i) {
+        co_await sleepUntil(start + duration * i / steps);
+        light.setBrightness(from + (target > from ? i : -i));
+    }
+    light.setBrightness(target);
+    std::cout << "[Behavior] " << light.getName() << " faded to " << target << "% at t="
+              << SimClock::format(SimClock::now()) << ".\n";
+}
+
+/**
+ * @brief Pre-heats with a thermostat, then holds the temperature.
+ *
+ * Switches the thermostat ON and raises its setpoint from the current value to
+ * `target` in 0.5 degree steps spread over `rampTime`, holds `target` for
+ * `holdTime`, then restores the previous setpoint and ON/OFF state.
+ */
+inline Behavior preheat(Thermostat& thermostat, float target, SimTime rampTime, SimTime holdTime) {
+    const float STEP = 0.5f;
+    SimTime start = SimClock::now();
+    float previous = thermostat.getSetpoint();
+    bool wasOn = thermostat.getState();
+    thermostat.setState(true);
+
+    int steps = std::max(1, static_cast<int>(std::ceil(std::fabs(target - previous) / STEP)));
+    for (int i = 1; i <= steps; ++i) {
+        co_await sleepUntil(start + rampTime * i / steps);
+        thermostat.setSetpoint(i == steps ? target : previous + (target > previous ? STEP : -STEP) * i);
+    }
+    std::cout << "[Behavior] " << thermostat.getName() << " reached " << target
+              << "C at t=" << SimClock::format(SimClock::now()) << ", holding for "
+              << SimClock::format(holdTime) << ".\n";
+
+    co_await sleepFor(holdTime);
+    thermostat.setSetpoint(previous);
+    thermostat.setState(wasOn);
+    std::cout << "[Behavior] " << thermostat.getName() << " finished pre-heat at t="
+              << SimClock::format(SimClock::now()) << ".\n";
+}
+
+#endif // DEVICE_BEHAVIORS_H
@@ -2,13 +2,19 @@
  * @file Sensor.h
  * @brief Simulated environmental sensor that notifies smart devices of changes.
  *
- * The `Sensor` class models an environmental sensor (e.g., temperature, humidity) that can notify
- * subscribed smart devices of environmental changes. Devices implement `onSensorTriggered(int)` 
- * to define how they react when the sensor triggers a new value.
+ * The `Sensor` class models one environmental sensor (e.g., a room's temperature,
+ * humidity, motion or light-level sensor) that publishes typed readings to the
+ * listeners subscribed to it. Devices implement `onSensorReading()` (by default
+ * forwarding temperature readings to `onSensorTriggered(int)`) to define how they react.
  *
  * This class supports:
- * - Publishing simulated sensor values
- * - Subscribing smart devices that observe these values
+ * - Publishing simulated, typed sensor values
+ * - Subscribing listeners (devices, controllers) that observe these values
+ * - Remembering the latest reading and a fixed-memory history (`SensorHistory`)
+ * - Suppressing fan-out of readings inside a deadband, below a minimum change or
+ *   within a minimum publish interval
+ *
+ * Sensors are normally created and looked up through `SensorRegistry`.
  *
  * Design Patterns:
  * - Implements a basic version of the Publisher/Subscriber model (Observer Pattern)
@@ -18,39 +24,139 @@
 #ifndef SENSOR_H
 #define SENSOR_H
 
-#include <vector>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
-#include "models/SmartDevice.h"
-#include "models/Thermostat.h"
-#include "strategies/TemperatureStrategy.h"
+#include <string>
+#include <vector>
+#include "SensorListener.h"
+#include "SensorReading.h"
+#include "SensorHistory.h"
+#include "../../utils/SimClock.h"
+
+/**
+ * @brief Change-suppression settings for a sensor.
+ *
+ * A reading is published only if it differs from the last published value by
+ * more than `deadband` (absolute) and by at least `minChange` (relative, e.g.
+ * 0.02 = 2%), and at least `minInterval` has passed since the last
+ * publish. With the defaults, only exact repeats of the last value are suppressed.
+ */
+struct PublishPolicy {
+    bool enabled = true;      ///< false = publish every reading
+    float deadband = 0.0f;    ///< Absolute noise band around the last published value
+    float minChange = 0.0f;   ///< Minimum relative change
+    SimTime minInterval = 0;  ///< Minimum time between publishes
+};
 
 class Sensor {
-    std::vector<SmartDevice*> subscribers; ///< List of subscribed smart devices
+    std::string id;                            ///< Sensor ID (e.g., "bedroom-temp")
+    SensorKind kind;                           ///< What the sensor measures
+    int handle;                                ///< Dense index assigned by the registry
+    bool shared = true;                        ///< false = local sensor (e.g., one room's thermometer)
+    SensorReading last;                        ///< Most recent reading
+    bool hasReading = false;                   ///< Whether anything was published yet
+    SensorHistory history;                     ///< Raw ring + multi-resolution rollups
+    PublishPolicy policy;                      ///< Change-suppression settings
+    float lastPublishedValue = 0.0f;           ///< Value of the last reading that was fanned out
+    SimTime lastPublishTime = 0;               ///< Time of the last reading that was fanned out
+    bool hasPublished = false;                 ///< Whether any reading was fanned out yet
+    long long publishedCount = 0;              ///< Readings delivered to subscribers
+    long long suppressedCount = 0;             ///< Readings stored without fan-out
+    std::vector<SensorListener*> subscribers;  ///< Contiguous list of subscribed listeners
 
 public:
     /**
-     * @brief Subscribes a smart device to receive sensor updates.
-     * @param device Pointer to a SmartDevice that should be notified of sensor changes
+     * @brief Constructs a sensor.
+     * @param sensorId Unique ID of the sensor
+     * @param sensorKind What the sensor measures
+     * @param sensorHandle Dense index assigned by the registry
+     */
+    Sensor(const std::string& sensorId, SensorKind sensorKind, int sensorHandle)
+        : id(sensorId), kind(sensorKind), handle(sensorHandle) {}
+
+    /**
+     * @brief Subscribes a listener to receive this sensor's readings.
+     * Subscribing the same listener twice has no effect.
+     * @param listener Pointer to a SensorListener (e.g., a SmartDevice)
      */
-    void subscribe(SmartDevice* device) {
-        subscribers.push_back(device);
+    void subscribe(SensorListener* listener) {
+        if (std::find(subscribers.begin(), subscribers.end(), listener) == subscribers.end())
+            subscribers.push_back(listener);
     }
 
     /**
-     * @brief Triggers a new sensor value and notifies all subscribed devices.
-     * 
-     * Each device's `onSensorTriggered(int)` function will be called.
-     * Devices can then choose how to react based on the new sensor value.
+     * @brief Publishes a new reading and notifies all subscribed listeners.
      *
-     * @param newValue The new sensor value (e.g., temperature reading)
+     * The reading is stamped with this sensor's handle, kind, sharing and the
+     * current simulated time. It always becomes the stored value and enters the history;
+     * it is only fanned out to subscribers if it passes the publish policy.
+     *
+     * @param reading The new value
      */
-    void trigger(int newValue) {
-        std::cout << "[Sensor] Environmental change triggered! New value = " << newValue << "\n";
+    void publish(SensorReading reading) {
+        reading.sensor = handle;
+        reading.kind = kind;
+        reading.shared = shared;
+        reading.time = SimClock::now();
+        last = reading;
+        hasReading = true;
+        float value = reading.asFloat();
+        history.record(reading.time, value);
 
-        for (auto* device : subscribers) {
-            std::cout << "Notifying " << device->getName() << "...\n";
-            device->onSensorTriggered(newValue);  
+        if (isSuppressed(value, reading.time)) {
+            suppressedCount++;
+            return;
         }
+        publishedCount++;
+        hasPublished = true;
+        lastPublishedValue = value;
+        lastPublishTime = reading.time;
+
+        std::cout << "[Sensor] " << id << " (" << sensorKindName(kind) << ") reading = "
+                  << reading.toString() << "\n";
+        for (auto* listener : subscribers) {
+            listener->onSensorReading(reading);
+        }
+    }
+
+    /**
+     * @brief Triggers a new integer sensor value and notifies all subscribed listeners.
+     * @param newValue The new sensor value (e.g., temperature reading)
+     */
+    void trigger(int newValue) { publish(SensorReading::ofInt(newValue)); }
+
+    const std::string& getId() const { return id; }
+    SensorKind getKind() const { return kind; }
+    int getHandle() const { return handle; }
+    bool isShared() const { return shared; }
+    void setShared(bool s) { shared = s; }
+    bool hasValue() const { return hasReading; }
+    const SensorReading& lastReading() const { return last; }
+    size_t subscriberCount() const { return subscribers.size(); }
+    const SensorHistory& getHistory() const { return history; }
+    long long getPublishedCount() const { return publishedCount; }
+    long long getSuppressedCount() const { return suppressedCount; }
+    const PublishPolicy& getPolicy() const { return policy; }
+
+    /**
+     * @brief Replaces the change-suppression settings.
+     * @param p New settings
+     */
+    void setPolicy(const PublishPolicy& p) { policy = p; }
+
+private:
+    /**
+     * @brief Checks a reading against the publish policy.
+     * @return true if the reading should not be fanned out
+     */
+    bool isSuppressed(float value, SimTime time) const {
+        if (!policy.enabled || !hasPublished) return false;
+        float delta = std::fabs(value - lastPublishedValue);
+        if (delta <= policy.deadband) return true;
+        if (delta < policy.minChange * std::fabs(lastPublishedValue)) return true;
+        // After the clock was reset the last publish lies in the future; it no longer counts
+        return time >= lastPublishTime && time - lastPublishTime < policy.minInterval;
     }
 };
 
@@ -0,0 +1,195 @@
+/**
+ * @file SensorHistory.h
+ * @brief Fixed-memory reading history for a sensor with multi-resolution rollups.
+ *
+ * The `SensorHistory` class keeps a ring of the most recent raw samples plus
+ * min/max/average rollups at several resolutions (1 second, 1 minute, 1 hour by
+ * default). Each resolution is itself a ring of fixed size, so the memory used per
+ * sensor never grows. Queries over a time window are answered from the coarsest
+ * resolution that still gives enough points over that window.
+ *
+ * Responsibilities:
+ * - Record every reading into the raw ring and each rollup level
+ * - Summarize a trailing window (min/max/avg and a short trend)
+ * - Pick the cheapest resolution that is still accurate enough for a query
+ */
+
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "../../utils/SimClock.h"
+
+class SensorHistory {
+public:
+    static constexpr int RAW_CAPACITY = 256;     ///< Raw samples kept
+    static constexpr int LEVEL_CAPACITY = 120;   ///< Buckets kept per resolution
+    static constexpr int LEVEL_COUNT = 3;        ///< Number of rollup resolutions
+    static constexpr int MIN_POINTS = 20;        ///< Points a query should be built from
+
+    /**
+     * @brief min/max/sum/count of the readings inside one bucket.
+     */
+    struct Rollup {
+        int64_t index = -1; ///< Absolute bucket number (time / width), or the sample time for raw points; -1 if unused
+        float min = 0.0f;
+        float max = 0.0f;
+        double sum = 0.0;
+        int count = 0;
+    };
+
+private:
+    /**
+     * @brief One raw reading.
+     */
+    struct Sample {
+        SimTime time;
+        float value;
+    };
+
+    static constexpr std::array<SimTime, LEVEL_COUNT> widths{SimClock::SECOND, SimClock::MINUTE, SimClock::HOUR};  ///< Bucket widths
+
+    std::array<Sample, RAW_CAPACITY> raw{};                              ///< Ring of raw samples
+    int rawCount = 0;                                                    ///< Samples ever recorded
+    std::array<std::array<Rollup, LEVEL_CAPACITY>, LEVEL_COUNT> levels{};  ///< Rollup rings
+
+    /**
+     * @brief Returns the ring slot of an absolute bucket index (non-negative for any index).
+     */
+    static int slotOf(int64_t index) {
+        int64_t slot = index % LEVEL_CAPACITY;
+        return static_cast<int>(slot < 0 ? slot + LEVEL_CAPACITY : slot);
+    }
+
+public:
+    /**
+     * @brief Records one reading.
+     * @param time Simulated time of the reading
+     * @param value Reading converted to a float
+     */
+    void record(SimTime time, float value) {
+        raw[rawCount % RAW_CAPACITY] = Sample{time, value};
+        rawCount++;
+
+        for (int l = 0; l < LEVEL_COUNT; ++l) {
+            int64_t index = time / widths[l];
+            Rollup& b = levels[l][slotOf(index)];
+            if (b.index > index) continue;  // Older than what the slot holds (time was reset)
+            if (b.index != index) b = Rollup{index, value, value, 0.0, 0};
+            b.min = std::min(b.min, value);
+            b.max = std::max(b.max, value);
+            b.sum += value;
+            b.count++;
+        }
+    }
+
+    /**
+     * @brief Chooses the resolution used to answer a query over a window.
+     *
+     * The coarsest level that both covers the window and yields at least
+     * MIN_POINTS buckets is preferred. If none does, raw samples are used when the
+     * raw ring still reaches back over the window, otherwise the finest level that
+     * covers it (or the coarsest level for very long windows).
+     *
+     * @param now Current simulated time
+     * @param window Length of the window
+     * @return Level index, or -1 for raw samples
+     */
+    int chooseLevel(SimTime now, SimTime window) const {
+        for (int l = LEVEL_COUNT - 1; l >= 0; --l) {
+            bool enoughPoints = window / widths[l] >= MIN_POINTS;
+            bool covers = window <= widths[l] * LEVEL_CAPACITY;
+            if (enoughPoints && covers) return l;
+        }
+        SimTime oldestRaw = rawCount == 0 ? now : raw[rawCount < RAW_CAPACITY ? 0 : rawCount % RAW_CAPACITY].time;
+        if (rawCount <= RAW_CAPACITY || now - window >= oldestRaw) return -1;
+        for (int l = 0; l < LEVEL_COUNT; ++l) {
+            if (window <= widths[l] * LEVEL_CAPACITY) return l;
+        }
+        return LEVEL_COUNT - 1;
+    }
+
+    /**
+     * @brief Summarizes the readings in (now - window, now] at the chosen resolution.
+     * @param window Length of the window
+     * @param now Current simulated time
+     * @param level Level from chooseLevel(), or -1 for raw samples
+     * @param points Receives the per-bucket rollups in time order
+     * @return Rollup over the whole window (count == 0 if no readings)
+     */
+    Rollup summarize(SimTime now, SimTime window, int level, std::vector<Rollup>& points) const {
+        Rollup total{0, std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0, 0};
+        points.clear();
+        SimTime from = now - window;
+
+        auto add = [&](const Rollup& r) {
+            total.min = std::min(total.min, r.min);
+            total.max = std::max(total.max, r.max);
+            total.sum += r.sum;
+            total.count += r.count;
+            points.push_back(r);
+        };
+
+        if (level < 0) {
+            int n = std::min(rawCount, RAW_CAPACITY);
+            for (int i = rawCount - n; i < rawCount; ++i) {
+                const Sample& s = raw[i % RAW_CAPACITY];
+                if (s.time > from && s.time <= now) add(Rollup{s.time, s.value, s.value, s.value, 1});
+            }
+            return total;
+        }
+
+        SimTime width = widths[level];
+        int64_t last = now / width;
+        int64_t first = std::max<int64_t>(last - LEVEL_CAPACITY + 1, (from + 1) / width);
+        for (int64_t index = first; index <= last; ++index) {
+            const Rollup& b = levels[level][slotOf(index)];
+            if (b.index == index && b.count > 0) add(b);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Prints a window summary and trend, as used by "sensor-history".
+     * @param now Current simulated time
+     * @param window Length of the window
+     */
+    void print(SimTime now, SimTime window) const {
+        int level = chooseLevel(now, window);
+        std::vector<Rollup> points;
+        Rollup total = summarize(now, window, level, points);
+
+        std::cout << "Resolution: " << (level < 0 ? std::string("raw samples")
+                                                   : SimClock::format(widths[level]) + " buckets")
+                  << ", " << points.size() << " points\n";
+        if (total.count == 0) {
+            std::cout << "No readings in the last " << SimClock::format(window) << ".\n";
+            return;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "min " << total.min << ", max " << total.max
+                  << ", avg " << total.sum / total.count << " over " << total.count << " readings\n";
+
+        // Trend: average of the first vs. the last third of the points
+        size_t third = std::max<size_t>(1, points.size() / 3);
+        double early = 0.0, late = 0.0;
+        int earlyCount = 0, lateCount = 0;
+        for (size_t i = 0; i < third; ++i) {
+            early += points[i].sum;
+            earlyCount += points[i].count;
+            late += points[points.size() - 1 - i].sum;
+            lateCount += points[points.size() - 1 - i].count;
+        }
+        double delta = late / lateCount - early / earlyCount;
+        std::cout << "trend: " << (delta > 0.05 ? "rising" : delta < -0.05 ? "falling" : "steady")
+                  << " (" << std::showpos << delta << std::noshowpos << ")\n" << std::defaultfloat << std::setprecision(6);
+    }
+};
+
+#endif // SENSOR_HISTORY_H
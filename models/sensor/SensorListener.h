@@ -0,0 +1,13 @@
+#ifndef SENSOR_LISTENER_H
+#define SENSOR_LISTENER_H
+
+#include "SensorReading.h"
+
+// Anything that can subscribe to sensor readings (devices, controllers)
+class SensorListener {
+public:
+    virtual void onSensorReading(const SensorReading& reading) = 0;
+    virtual ~SensorListener() {}
+};
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file SensorReading.h
+ * @brief Typed sensor readings and sensor kinds for SmartHomeSim.
+ *
+ * A `SensorReading` carries one value published by a sensor together with the
+ * sensor's handle, its kind and the simulated time. Values are typed: integer
+ * (e.g., light level), floating point (e.g., temperature, humidity) or boolean
+ * (e.g., motion detected).
+ *
+ * Responsibilities:
+ * - Enumerate the supported sensor kinds
+ * - Hold a tagged value with conversion helpers
+ * - Convert kinds to and from their CLI names
+ */
+
+#ifndef SENSOR_READING_H
+#define SENSOR_READING_H
+
+#include <string>
+#include "../../utils/SimClock.h"
+
+/**
+ * @brief Physical quantity measured by a sensor.
+ */
+enum class SensorKind { Temperature, Humidity, Motion, LightLevel };
+
+constexpr int SENSOR_KIND_COUNT = 4;  ///< Number of SensorKind values
+
+/**
+ * @brief One value published by a sensor.
+ */
+struct SensorReading {
+    enum class Type { Int, Float, Bool };
+
+    int sensor = -1;                              ///< Handle of the publishing sensor
+    SensorKind kind = SensorKind::Temperature;    ///< Kind of the publishing sensor
+    Type type = Type::Int;                        ///< Which member of the value union is set
+    SimTime time = 0;                             ///< Simulated time of the reading
+    bool shared = true;                           ///< false = from a local sensor (not representative of its kind)
+    union {
+        int i;
+        float f;
+        bool b;
+    };
+
+    SensorReading() : i(0) {}
+
+    static SensorReading ofInt(int v) { SensorReading r; r.type = Type::Int; r.i = v; return r; }
+    static SensorReading ofFloat(float v) { SensorReading r; r.type = Type::Float; r.f = v; return r; }
+    static SensorReading ofBool(bool v) { SensorReading r; r.type = Type::Bool; r.b = v; return r; }
+
+    /**
+     * @brief Returns the value as a float regardless of its stored type.
+     */
+    float asFloat() const {
+        switch (type) {
+            case Type::Int: return static_cast<float>(i);
+            case Type::Float: return f;
+            default: return b ? 1.0f : 0.0f;
+        }
+    }
+
+    /**
+     * @brief Returns the value as an integer (floats are truncated).
+     */
+    int asInt() const {
+        switch (type) {
+            case Type::Int: return i;
+            case Type::Float: return static_cast<int>(f);
+            default: return b ? 1 : 0;
+        }
+    }
+
+    /**
+     * @brief Returns the value as a boolean (non-zero is true).
+     */
+    bool asBool() const { return type == Type::Bool ? b : asFloat() != 0.0f; }
+
+    /**
+     * @brief Formats the value for console output.
+     */
+    std::string toString() const {
+        switch (type) {
+            case Type::Int: return std::to_string(i);
+            case Type::Bool: return b ? "true" : "false";
+            default: {
+                std::string s = std::to_string(f);
+                s.erase(s.find_last_not_of('0') + 1);
+                if (s.back() == '.') s.pop_back();
+                return s;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Returns the CLI name of a sensor kind.
+ */
+inline const char* sensorKindName(SensorKind kind) {
+    switch (kind) {
+        case SensorKind::Temperature: return "temperature";
+        case SensorKind::Humidity: return "humidity";
+        case SensorKind::Motion: return "motion";
+        default: return "light";
+    }
+}
+
+/**
+ * @brief Parses a CLI sensor kind name.
+ * @param name "temperature", "humidity", "motion" or "light"
+ * @param kind Receives the parsed kind
+ * @return true if the name is valid
+ */
+inline bool parseSensorKind(const std::string& name, SensorKind& kind) {
+    for (int k = 0; k < SENSOR_KIND_COUNT; ++k) {
+        if (name == sensorKindName(static_cast<SensorKind>(k))) {
+            kind = static_cast<SensorKind>(k);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the natural value type of readings of a kind.
+ */
+inline SensorReading::Type readingTypeOf(SensorKind kind) {
+    switch (kind) {
+        case SensorKind::Motion: return SensorReading::Type::Bool;
+        case SensorKind::LightLevel: return SensorReading::Type::Int;
+        default: return SensorReading::Type::Float;
+    }
+}
+
+#endif // SENSOR_READING_H
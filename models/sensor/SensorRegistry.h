@@ -0,0 +1,157 @@
+/**
+ * @file SensorRegistry.h
+ * @brief Registry of all sensors in the home, keyed by sensor ID and kind.
+ *
+ * The `SensorRegistry` class owns every `Sensor` and lets listeners subscribe either
+ * to one sensor or to all sensors of a kind (e.g., every temperature sensor). Kind
+ * subscriptions are expanded into the per-sensor subscriber lists, including for
+ * sensors added later, so each reading is delivered with a single loop over the
+ * publishing sensor's contiguous list and reaches only its real subscribers.
+ *
+ * Responsibilities:
+ * - Create and look up sensors by ID
+ * - Route per-sensor and per-kind subscriptions
+ * - Parse typed readings from CLI input
+ * - List sensors with their latest readings and publish/suppress counters
+ */
+
+#ifndef SENSOR_REGISTRY_H
+#define SENSOR_REGISTRY_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Sensor.h"
+
+class SensorRegistry {
+    std::vector<std::unique_ptr<Sensor>> sensors;                   ///< Indexed by sensor handle
+    std::unordered_map<std::string, int> handles;                   ///< Sensor ID -> handle
+    std::vector<SensorListener*> kindSubscribers[SENSOR_KIND_COUNT];  ///< Per-kind subscriptions
+    std::vector<int> localSensors;                                  ///< Handles of local sensors, ascending
+
+public:
+    /**
+     * @brief Adds a new sensor.
+     * @param id Unique sensor ID
+     * @param kind What the sensor measures
+     * @param shared false for a local sensor (e.g., one room's thermometer) that only
+     *        reaches its explicit subscribers, not the listeners of its whole kind
+     * @return Pointer to the new sensor, or nullptr if the ID is taken
+     */
+    Sensor* addSensor(const std::string& id, SensorKind kind, bool shared = true) {
+        if (handles.count(id)) return nullptr;
+        int handle = static_cast<int>(sensors.size());
+        sensors.push_back(std::make_unique<Sensor>(id, kind, handle));
+        handles[id] = handle;
+        if (shared) {
+            for (auto* listener : kindSubscribers[static_cast<int>(kind)]) {
+                sensors.back()->subscribe(listener);
+            }
+        } else {
+            sensors.back()->setShared(false);
+            localSensors.push_back(handle);
+        }
+        return sensors.back().get();
+    }
+
+    /**
+     * @brief Finds a sensor by ID.
+     * @return Pointer to the sensor, or nullptr if not found
+     */
+    Sensor* find(const std::string& id) const {
+        auto it = handles.find(id);
+        return it == handles.end() ? nullptr : sensors[it->second].get();
+    }
+
+    /**
+     * @brief Returns the sensor with the given handle.
+     */
+    Sensor* at(int handle) const { return sensors[handle].get(); }
+
+    /**
+     * @brief Subscribes a listener to one sensor.
+     * @return false if the sensor does not exist
+     */
+    bool subscribe(const std::string& id, SensorListener* listener) {
+        Sensor* s = find(id);
+        if (!s) return false;
+        s->subscribe(listener);
+        return true;
+    }
+
+    /**
+     * @brief Subscribes a listener to every shared sensor of a kind, current and future.
+     */
+    void subscribeKind(SensorKind kind, SensorListener* listener) {
+        kindSubscribers[static_cast<int>(kind)].push_back(listener);
+        size_t local = 0;
+        for (auto& s : sensors) {
+            if (local < localSensors.size() && localSensors[local] == s->getHandle()) {
+                local++;
+                continue;
+            }
+            if (s->getKind() == kind) s->subscribe(listener);
+        }
+    }
+
+    /**
+     * @brief Parses a reading for a sensor from text according to its kind.
+     *
+     * Temperature and humidity are floats, light level is an integer and motion
+     * is a boolean ("1"/"0", "true"/"false", "on"/"off").
+     *
+     * @param sensor Target sensor
+     * @param text Value entered by the user
+     * @param out Receives the parsed reading
+     * @return true on success
+     */
+    static bool parseReading(const Sensor& sensor, const std::string& text, SensorReading& out) {
+        try {
+            switch (readingTypeOf(sensor.getKind())) {
+                case SensorReading::Type::Float: out = SensorReading::ofFloat(std::stof(text)); return true;
+                case SensorReading::Type::Int: out = SensorReading::ofInt(std::stoi(text)); return true;
+                default:
+                    if (text == "1" || text == "true" || text == "on") { out = SensorReading::ofBool(true); return true; }
+                    if (text == "0" || text == "false" || text == "off") { out = SensorReading::ofBool(false); return true; }
+                    return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    /**
+     * @brief Returns all sensors, indexed by handle.
+     */
+    const std::vector<std::unique_ptr<Sensor>>& all() const { return sensors; }
+
+    /**
+     * @brief Lists all sensors with their kind, subscriber count and latest reading.
+     */
+    void listSensors() const {
+        if (sensors.empty()) {
+            std::cout << "[System] No sensors registered.\n";
+            return;
+        }
+        std::cout << "\n=== Registered Sensors ===\n";
+        for (const auto& s : sensors) {
+            std::cout << "- " << s->getId() << " [" << sensorKindName(s->getKind()) << "] "
+                      << s->subscriberCount() << " subscribers, last = "
+                      << (s->hasValue() ? s->lastReading().toString() : "n/a")
+                      << ", published " << s->getPublishedCount()
+                      << ", suppressed " << s->getSuppressedCount() << "\n";
+            const PublishPolicy& p = s->getPolicy();
+            if (p.enabled) {
+                std::cout << "    deadband " << p.deadband << ", min change " << p.minChange * 100.0f
+                          << "%, min interval " << SimClock::format(p.minInterval) << "\n";
+            } else {
+                std::cout << "    suppression off\n";
+            }
+        }
+        std::cout << "==========================\n";
+    }
+};
+
+#endif // SENSOR_REGISTRY_H
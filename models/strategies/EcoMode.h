@@ -29,6 +29,11 @@ public:
     void apply() override {
         std::cout << "[Thermostat] Eco Mode: Set to 68°F for energy saving.\n";
     }
+
+    /**
+     * @brief Eco Mode runs the thermostat at half power.
+     */
+    float output() const override { return 0.5f; }
 };
 
 #endif // ECO_MODE_H
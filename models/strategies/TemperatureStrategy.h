@@ -25,6 +25,12 @@ public:
      */
     virtual void apply() = 0;
 
+    /**
+     * @brief Fraction of the thermostat's full heating/cooling power this mode uses.
+     * Becomes the output limit of the thermostat's PID controller.
+     */
+    virtual float output() const { return 1.0f; }
+
     /**
      * @brief Virtual destructor to allow proper cleanup in derived classes.
      */
@@ -0,0 +1,283 @@
+/**
+ * @file CronSchedule.h
+ * @brief Concrete strategy for cron-style recurring schedules in SmartHomeSim.
+ *
+ * The CronSchedule class triggers a task on every minute matching a standard
+ * five-field cron expression:
+ *
+ *     minute hour day-of-month month day-of-week
+ *
+ * Each field accepts `*`, numbers, ranges (`9-17`), steps (`0-30/10`, or `*` followed
+ * by `/n`) and comma-separated lists; months and weekdays also accept names (`jan`,
+ * `mon-fri`). Examples: `0 7 * * mon-fri` (weekdays at 07:00), `0-59/15 9-17 * * *`
+ * (every 15 minutes from 09:00 to 17:45).
+ *
+ * The expression is compiled once into bitmask tables (one bit per allowed minute,
+ * hour, day, month and weekday). shouldTrigger() is then a handful of bit tests,
+ * and nextFireTime() skips whole days and uses bit scans for hours and minutes.
+ *
+ * Simulated calendar: t = 0 is Monday, January 1, 00:00 of a 365-day year, and
+ * every year has 365 days. The calendar arithmetic runs on whole seconds; times
+ * are converted from and to SimTime microseconds at the interface.
+ *
+ * Design Pattern:
+ * - Strategy Pattern: Implements SchedulingStrategy for calendar-based triggering behavior.
+ *
+ * Responsibilities:
+ * - Parse and validate cron expressions
+ * - Match a simulated time against the compiled tables in O(1)
+ * - Compute the next matching time without polling
+ */
+
+#ifndef CRON_SCHEDULE_H
+#define CRON_SCHEDULE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "SchedulingStrategy.h"
+
+/**
+ * @brief Cron strategy: triggers at second 0 of every matching minute.
+ */
+class CronSchedule : public SchedulingStrategy {
+private:
+    static constexpr int64_t DAY = 86400;                    ///< Seconds per day
+    static constexpr int DAYS_PER_YEAR = 365;
+    static constexpr int SEARCH_DAYS = 7 * DAYS_PER_YEAR + 1;  ///< Calendar repeats after 7 years
+
+    uint64_t minutes = 0;     ///< Bit m = minute m allowed (0-59)
+    uint32_t hours = 0;       ///< Bit h = hour h allowed (0-23)
+    uint32_t monthDays = 0;   ///< Bit d = day of month d allowed (1-31)
+    uint16_t months = 0;      ///< Bit m = month m allowed (1-12)
+    uint8_t weekDays = 0;     ///< Bit d = weekday d allowed (0 = Sunday)
+    bool anyMonthDay = true;  ///< Day-of-month field was "*"
+    bool anyWeekDay = true;   ///< Day-of-week field was "*"
+    std::string expression;   ///< Source text, for display
+
+    CronSchedule() = default;
+
+public:
+    /**
+     * @brief Compiles a cron expression.
+     * @param expr Five whitespace-separated fields
+     * @param error Receives a message if the expression is invalid
+     * @return A new strategy, or nullptr on error
+     */
+    static CronSchedule* compile(const std::string& expr, std::string& error) {
+        std::string_view fields[5];
+        std::string_view rest(expr);
+        for (auto& f : fields) {
+            rest.remove_prefix(std::min(rest.find_first_not_of(" \t"), rest.size()));
+            size_t end = std::min(rest.find_first_of(" \t"), rest.size());
+            f = rest.substr(0, end);
+            rest.remove_prefix(end);
+        }
+        if (fields[4].empty() || rest.find_first_not_of(" \t") != std::string_view::npos) {
+            error = "A cron expression has 5 fields: minute hour day month weekday.";
+            return nullptr;
+        }
+
+        static const char* monthNames[] = {"jan", "feb", "mar", "apr", "may", "jun",
+                                           "jul", "aug", "sep", "oct", "nov", "dec"};
+        static const char* dayNames[] = {"sun", "mon", "tue", "wed", "thu", "fri", "sat"};
+
+        CronSchedule* c = new CronSchedule();
+        c->expression = expr;
+        uint64_t bits[5];
+        bool ok = parseField(fields[0], 0, 59, nullptr, 0, bits[0])
+               && parseField(fields[1], 0, 23, nullptr, 0, bits[1])
+               && parseField(fields[2], 1, 31, nullptr, 0, bits[2])
+               && parseField(fields[3], 1, 12, monthNames, 12, bits[3])
+               && parseField(fields[4], 0, 7, dayNames, 7, bits[4]);
+        if (!ok) {
+            error = "Invalid cron field in \"" + expr + "\".";
+            delete c;
+            return nullptr;
+        }
+        if (bits[4] & (1u << 7)) bits[4] |= 1;  // 7 is also Sunday
+        c->minutes = bits[0];
+        c->hours = static_cast<uint32_t>(bits[1]);
+        c->monthDays = static_cast<uint32_t>(bits[2]);
+        c->months = static_cast<uint16_t>(bits[3]);
+        c->weekDays = static_cast<uint8_t>(bits[4] & 0x7F);
+        c->anyMonthDay = fields[2] == "*";
+        c->anyWeekDay = fields[4] == "*";
+        return c;
+    }
+
+    /**
+     * @brief Checks whether the current time is the start of a matching minute.
+     * @param currentTime The current simulated time
+     * @return true if the task should trigger now
+     */
+    bool shouldTrigger(SimTime currentTime) override {
+        if (currentTime < 0 || currentTime % SimClock::MINUTE != 0) return false;
+        int64_t seconds = currentTime / SimClock::SECOND;
+        int secondOfDay = static_cast<int>(seconds % DAY);
+        return ((minutes >> (secondOfDay / 60 % 60)) & 1)
+            && ((hours >> (secondOfDay / 3600)) & 1)
+            && dayMatches(seconds / DAY);
+    }
+
+    /**
+     * @brief Cron schedules repeat forever.
+     * @return false always
+     */
+    bool isDone() const override {
+        return false;
+    }
+
+    /**
+     * @brief Cron schedules repeat at every matching time.
+     * @return true always
+     */
+    bool isRecurring() const override {
+        return true;
+    }
+
+    /**
+     * @brief Finds the first matching minute strictly after `after`.
+     * @param after The time from which to search (exclusive)
+     * @return The next trigger time, or NEVER if no date ever matches
+     */
+    SimTime nextFireTime(SimTime after) const override {
+        int64_t t = after < 0 ? 0 : (after / SimClock::MINUTE + 1) * 60;  // Seconds from here on
+        int64_t day = t / DAY;
+        int hour = static_cast<int>(t % DAY / 3600);
+        int minute = static_cast<int>(t % 3600 / 60);
+
+        for (int searched = 0; searched < SEARCH_DAYS; ++searched, ++day, hour = 0, minute = 0) {
+            if (!dayMatches(day)) continue;
+            for (;;) {
+                int h = firstBitFrom(hours, hour);
+                if (h < 0) break;
+                int m = firstBitFrom(minutes, h == hour ? minute : 0);
+                if (m >= 0) return (day * DAY + h * 3600 + m * 60) * SimClock::SECOND;
+                hour = h + 1;
+                minute = 0;
+                if (hour >= 24) break;
+            }
+        }
+        return NEVER;
+    }
+
+    /**
+     * @brief Returns the expression this schedule was compiled from.
+     */
+    const std::string& getExpression() const { return expression; }
+
+private:
+    /**
+     * @brief Checks the day-of-month, month and weekday tables for an absolute day.
+     *
+     * As in cron, when both day-of-month and weekday are restricted, either may match.
+     */
+    bool dayMatches(int64_t day) const {
+        const Date& date = calendar()[day % DAYS_PER_YEAR];
+        if (!((months >> date.month) & 1)) return false;
+        bool domOk = (monthDays >> date.dayOfMonth) & 1;
+        bool dowOk = (weekDays >> ((day + 1) % 7)) & 1;  // Day 0 is a Monday
+        if (anyMonthDay) return dowOk;
+        if (anyWeekDay) return domOk;
+        return domOk || dowOk;
+    }
+
+    /**
+     * @brief Month and day of month of a day of the year.
+     */
+    struct Date {
+        uint8_t month;       ///< 1-12
+        uint8_t dayOfMonth;  ///< 1-31
+    };
+
+    /**
+     * @brief Day-of-year lookup table for the 365-day simulated year.
+     */
+    static const std::array<Date, DAYS_PER_YEAR>& calendar() {
+        static const std::array<Date, DAYS_PER_YEAR> table = [] {
+            std::array<Date, DAYS_PER_YEAR> t{};
+            const int lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+            int d = 0;
+            for (int m = 0; m < 12; ++m) {
+                for (int dom = 1; dom <= lengths[m]; ++dom) {
+                    t[d++] = Date{static_cast<uint8_t>(m + 1), static_cast<uint8_t>(dom)};
+                }
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    /**
+     * @brief Returns the lowest set bit at or above `from`, or -1.
+     */
+    static int firstBitFrom(uint64_t mask, int from) {
+        if (from >= 64) return -1;
+        uint64_t rest = mask & (~uint64_t(0) << from);
+        return rest ? __builtin_ctzll(rest) : -1;
+    }
+
+    /**
+     * @brief Parses one field ("*", "a", "a-b", "a/n", "a-b/n", lists) into a bitmask.
+     * @param names Optional lowercase names for the values starting at `lo`
+     */
+    static bool parseField(std::string_view field, int lo, int hi, const char* const* names,
+                           int nameCount, uint64_t& bits) {
+        bits = 0;
+        while (!field.empty()) {
+            size_t comma = field.find(',');
+            std::string_view part = field.substr(0, comma);
+            field.remove_prefix(comma == std::string_view::npos ? field.size() : comma + 1);
+            int step = 1;
+            size_t slash = part.find('/');
+            if (slash != std::string_view::npos) {
+                if (!parseValue(part.substr(slash + 1), 1, hi, nullptr, 0, step)) return false;
+                part = part.substr(0, slash);
+            }
+            int from = lo, to = hi;
+            if (part != "*") {
+                size_t dash = part.find('-');
+                if (!parseValue(part.substr(0, dash), lo, hi, names, nameCount, from)) return false;
+                to = from;
+                if (dash != std::string_view::npos) {
+                    if (!parseValue(part.substr(dash + 1), lo, hi, names, nameCount, to)) return false;
+                } else if (slash != std::string_view::npos) {
+                    to = hi;  // "a/n" means a, a+n, ... up to the maximum
+                }
+                if (to < from) return false;
+            }
+            for (int v = from; v <= to; v += step) bits |= uint64_t(1) << v;
+        }
+        return bits != 0;
+    }
+
+    /**
+     * @brief Parses a number or a name; names[i] stands for the value lo + i.
+     */
+    static bool parseValue(std::string_view text, int lo, int hi, const char* const* names,
+                           int nameCount, int& value) {
+        if (text.empty()) return false;
+        if (text.size() == 3) {
+            char lower[3];
+            for (int i = 0; i < 3; ++i) lower[i] = static_cast<char>(text[i] >= 'A' && text[i] <= 'Z' ? text[i] - 'A' + 'a' : text[i]);
+            for (int i = 0; i < nameCount; ++i) {
+                if (std::string_view(lower, 3) == names[i]) {
+                    value = lo + i;
+                    return true;
+                }
+            }
+        }
+        value = 0;
+        for (char ch : text) {
+            if (ch < '0' || ch > '9') return false;
+            value = value * 10 + (ch - '0');
+            if (value > hi) return false;
+        }
+        return value >= lo;
+    }
+};
+
+#endif // CRON_SCHEDULE_H
@@ -23,7 +23,7 @@
  */
 class DelayedSchedule : public SchedulingStrategy {
 private:
-    int startTime;       ///< Time (in seconds) at which to trigger the task
+    SimTime startTime;   ///< Time at which to trigger the task
     bool triggered = false; ///< Tracks whether the task has been triggered
 
 public:
@@ -31,14 +31,14 @@ public:
      * @brief Constructor for delayed schedule.
      * @param time The simulation time after which the task should trigger
      */
-    DelayedSchedule(int time) : startTime(time) {}
+    DelayedSchedule(SimTime time) : startTime(time) {}
 
     /**
      * @brief Checks if the current time has reached or passed the trigger time.
      * @param currentTime The current simulated time
      * @return true if the task should trigger now
      */
-    bool shouldTrigger(int currentTime) override {
+    bool shouldTrigger(SimTime currentTime) override {
         if (!triggered && currentTime >= startTime) {
             triggered = true;
             return true;
@@ -53,6 +53,16 @@ public:
     bool isDone() const override {
         return triggered;
     }
+
+    /**
+     * @brief Returns the start time, or right away if it has already passed.
+     * @param after The time from which to search (exclusive)
+     * @return The next trigger time, or NEVER once triggered
+     */
+    SimTime nextFireTime(SimTime after) const override {
+        if (triggered) return NEVER;
+        return startTime > after ? startTime : after + 1;
+    }
 };
 
 #endif // DELAYED_SCHEDULE_H
@@ -24,21 +24,21 @@
  */
 class OneTimeSchedule : public SchedulingStrategy {
 private:
-    int triggerTime;  ///< Time at which the task should trigger (in seconds)
+    SimTime triggerTime;  ///< Time at which the task should trigger
 
 public:
     /**
      * @brief Constructor for one-time schedule.
-     * @param time The specific time (in seconds) to trigger the action
+     * @param time The specific simulated time to trigger the action
      */
-    OneTimeSchedule(int time) : triggerTime(time) {}
+    OneTimeSchedule(SimTime time) : triggerTime(time) {}
 
     /**
      * @brief Checks whether the current time matches the trigger time.
      * @param currentTime The current simulated time
      * @return true if the task should trigger now
      */
-    bool shouldTrigger(int currentTime) override {
+    bool shouldTrigger(SimTime currentTime) override {
         return currentTime == triggerTime;
     }
 
@@ -49,6 +49,15 @@ public:
     bool isDone() const override {
         return true;
     }
+
+    /**
+     * @brief Returns the trigger time if it is still ahead.
+     * @param after The time from which to search (exclusive)
+     * @return The trigger time, or NEVER if it has passed
+     */
+    SimTime nextFireTime(SimTime after) const override {
+        return triggerTime > after ? triggerTime : NEVER;
+    }
 };
 
 #endif // ONE_TIME_SCHEDULE_H
@@ -24,21 +24,21 @@
  */
 class PeriodicSchedule : public SchedulingStrategy {
 private:
-    int interval;  ///< Time interval (in seconds) between task executions
+    SimTime interval;  ///< Time interval between task executions
 
 public:
     /**
      * @brief Constructor for periodic schedule.
-     * @param intervalSeconds Interval in seconds at which to trigger
+     * @param every Interval at which to trigger (may be below a second, e.g. 100 ms for 10 Hz)
      */
-    PeriodicSchedule(int intervalSeconds) : interval(intervalSeconds) {}
+    PeriodicSchedule(SimTime every) : interval(every) {}
 
     /**
      * @brief Determines whether the current time matches the interval.
      * @param currentTime The current simulated time
      * @return true if the task should trigger at this time
      */
-    bool shouldTrigger(int currentTime) override {
+    bool shouldTrigger(SimTime currentTime) override {
         return (currentTime % interval == 0);
     }
 
@@ -49,6 +49,23 @@ public:
     bool isDone() const override {
         return false;
     }
+
+    /**
+     * @brief Periodic schedules repeat at every matching time.
+     * @return true always
+     */
+    bool isRecurring() const override {
+        return true;
+    }
+
+    /**
+     * @brief Returns the next multiple of the interval.
+     * @param after The time from which to search (exclusive)
+     * @return The next trigger time
+     */
+    SimTime nextFireTime(SimTime after) const override {
+        return (after / interval + 1) * interval;
+    }
 };
 
 #endif // PERIODIC_SCHEDULE_H
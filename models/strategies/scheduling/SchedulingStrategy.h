@@ -11,28 +11,34 @@
  *
  * Responsibilities:
  * - Define an interface for time-based task evaluation
+ * - Report the next time a task is due, so the Scheduler does not poll every tick
  * - Enable dynamic extension of scheduling logic without modifying the Scheduler
  */
 
 #ifndef SCHEDULING_STRATEGY_H
 #define SCHEDULING_STRATEGY_H
 
+#include "../../../utils/SimClock.h"
+
 /**
  * @brief Abstract base class for time-based scheduling strategies.
  *
  * Subclasses must implement shouldTrigger() to specify when a device should change state.
  * The default isDone() assumes a one-time execution but may be overridden for periodic tasks.
+ * Subclasses should also override nextFireTime(); the default asks to be checked every tick.
  */
 class SchedulingStrategy {
 public:
+    static constexpr SimTime NEVER = -1;  ///< nextFireTime() result when the strategy will not fire again
+
     virtual ~SchedulingStrategy() {}
 
     /**
      * @brief Determines whether the action should be triggered at the given time.
-     * @param currentTime The current simulated time
+     * @param currentTime The current simulated time (microseconds)
      * @return true if the task should execute, false otherwise
      */
-    virtual bool shouldTrigger(int currentTime) = 0;
+    virtual bool shouldTrigger(SimTime currentTime) = 0;
 
     /**
      * @brief Indicates whether the task is finished after triggering.
@@ -40,6 +46,21 @@ public:
      * @return true if no longer needed, false if it should repeat
      */
     virtual bool isDone() const { return true; }
+
+    /**
+     * @brief Returns the first time strictly after `after` at which the task may trigger.
+     * The default polls: it asks to be checked again one tick (one simulated second) later.
+     * @param after The time from which to search (exclusive)
+     * @return The next candidate time, or NEVER
+     */
+    virtual SimTime nextFireTime(SimTime after) const { return after + SimClock::SECOND; }
+
+    /**
+     * @brief Indicates whether the task fires repeatedly rather than once.
+     * Used to look ahead at future fire times; one-shot strategies only have their first.
+     * @return false by default
+     */
+    virtual bool isRecurring() const { return false; }
 };
 
 #endif // SCHEDULING_STRATEGY_H
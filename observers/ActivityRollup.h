@@ -0,0 +1,210 @@
+/**
+ * @file ActivityRollup.h
+ * @brief Observer that keeps constant-memory activity aggregates per device.
+ *
+ * The `ActivityRollup` class implements the Observer interface as a streaming
+ * alternative to `DeviceLogger`: instead of storing every transition it keeps, for
+ * each device, the number of transitions, the total ON time and the time of the
+ * last change, plus a ring of fixed-width time buckets (e.g., hourly) holding the
+ * same figures per bucket. Memory is O(devices x buckets) and does not grow with
+ * the number of events. The figures cover the time since the clock was last
+ * reset (see restart()), so the duty cycle is ON time over that period.
+ *
+ * This class supports:
+ * - Per-device transition counts, ON time and duty cycle
+ * - Per-bucket rollups over the most recent buckets
+ * - Printing the rollups via the "stats" CLI command
+ *
+ * Design Pattern:
+ * - Observer Pattern: This class observes `SmartDevice` instances for state changes.
+ */
+
+#ifndef ACTIVITY_ROLLUP_H
+#define ACTIVITY_ROLLUP_H
+
+#include "Observer.h"
+#include "../models/SmartDevice.h"
+#include "../utils/SimClock.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class ActivityRollup : public Observer {
+private:
+    /**
+     * @brief Aggregates for one time bucket of one device.
+     */
+    struct Bucket {
+        int64_t index = -1;    ///< Absolute bucket number (time / width), -1 if unused
+        int transitions = 0;   ///< State changes inside the bucket
+        SimTime onTime = 0;    ///< Time spent ON inside the bucket
+    };
+
+    /**
+     * @brief Running aggregates for one device.
+     */
+    struct DeviceRollup {
+        std::string label;           ///< "Type: Name", captured on first update
+        bool tracked = false;        ///< Whether the device has reported yet
+        bool on = false;             ///< State after the last transition
+        SimTime onSince = 0;         ///< Start of the current ON interval
+        SimTime lastChange = 0;      ///< Time of the last transition
+        long long transitions = 0;   ///< Total state changes
+        SimTime onTime = 0;          ///< Total closed ON time
+    };
+
+    SimTime bucketWidth;                 ///< Width of each bucket
+    int bucketCount;                     ///< Number of buckets retained per device
+    std::vector<DeviceRollup> rollups;   ///< Indexed by device handle
+    std::vector<Bucket> buckets;         ///< rollups.size() x bucketCount ring slots
+
+public:
+    /**
+     * @brief Constructs a rollup with the given bucket layout.
+     * @param width Width of each time bucket (default: one hour)
+     * @param count Number of most recent buckets kept per device
+     */
+    ActivityRollup(SimTime width = SimClock::HOUR, int count = 24)
+        : bucketWidth(width), bucketCount(count) {}
+
+    /**
+     * @brief Called when an observed device's state changes.
+     * Closes or opens the device's ON interval and bumps its counters.
+     *
+     * @param device Pointer to the smart device that triggered the update
+     */
+    void update(SmartDevice* device) override {
+        SimTime now = SimClock::now();
+        DeviceRollup& r = rollupFor(device);
+        bool on = device->getState();
+
+        if (r.on && !on) {
+            closeInterval(device->getId(), r, now);
+        } else if (on && !r.on) {
+            r.onSince = now;
+        }
+        r.on = on;
+        r.lastChange = now;
+        r.transitions++;
+
+        Bucket* b = bucketAt(device->getId(), now / bucketWidth);
+        if (b) b->transitions++;
+    }
+
+    /**
+     * @brief Starts a new measurement period at `now` (e.g., after the clock was reset).
+     * Totals and buckets restart from zero; devices that are ON count from `now`.
+     */
+    void restart(SimTime now) {
+        for (DeviceRollup& r : rollups) {
+            r.transitions = 0;
+            r.onTime = 0;
+            r.onSince = now;
+            r.lastChange = std::min(r.lastChange, now);
+        }
+        std::fill(buckets.begin(), buckets.end(), Bucket{});
+    }
+
+    /**
+     * @brief Prints the per-device rollups and the most recent buckets.
+     * Called by the "stats" command in the CLI.
+     */
+    void printStats() const {
+        SimTime now = SimClock::now();
+        int64_t currentBucket = now / bucketWidth;
+        int shown = static_cast<int>(std::min<int64_t>(bucketCount, currentBucket + 1));
+
+        std::cout << "\n===== Device Activity Rollups =====\n";
+        bool any = false;
+        for (size_t id = 0; id < rollups.size(); ++id) {
+            const DeviceRollup& r = rollups[id];
+            if (!r.tracked) continue;
+            any = true;
+
+            SimTime onTime = r.onTime + (r.on && now > r.onSince ? now - r.onSince : 0);
+            double duty = now > 0 ? 100.0 * onTime / now : (r.on ? 100.0 : 0.0);
+            std::cout << "- " << r.label << "\n"
+                      << "    transitions: " << r.transitions
+                      << ", ON time: " << SimClock::format(onTime)
+                      << ", duty cycle: " << std::fixed << std::setprecision(1) << duty << "%"
+                      << ", last change: t=" << SimClock::format(r.lastChange) << "\n";
+
+            std::cout << "    last " << shown << " x " << SimClock::format(bucketWidth) << " buckets (ON% / transitions):";
+            for (int64_t b = currentBucket - shown + 1; b <= currentBucket; ++b) {
+                const Bucket& slot = buckets[id * bucketCount + slotOf(b)];
+                int trans = slot.index == b ? slot.transitions : 0;
+                SimTime onInBucket = slot.index == b ? slot.onTime : 0;
+                // Add the still-open ON interval's share of this bucket
+                if (r.on) {
+                    SimTime from = std::max(r.onSince, b * bucketWidth);
+                    SimTime to = std::min(now, (b + 1) * bucketWidth);
+                    if (to > from) onInBucket += to - from;
+                }
+                SimTime span = std::min(bucketWidth, now - b * bucketWidth);
+                double pct = span > 0 ? 100.0 * onInBucket / span : 0.0;
+                std::cout << " " << std::setprecision(0) << pct << "%/" << trans;
+            }
+            std::cout << "\n";
+        }
+        if (!any) std::cout << "[Stats] No device activity recorded yet.\n";
+        std::cout << std::defaultfloat << std::setprecision(6) << "===================================\n";
+    }
+
+private:
+    /**
+     * @brief Returns the rollup for a device, growing the tables on first sight.
+     */
+    DeviceRollup& rollupFor(SmartDevice* device) {
+        size_t id = static_cast<size_t>(device->getId());
+        if (id >= rollups.size()) {
+            rollups.resize(id + 1);
+            buckets.resize(rollups.size() * bucketCount);
+        }
+        DeviceRollup& r = rollups[id];
+        if (!r.tracked) {
+            r.tracked = true;
+            r.label = device->getType() + ": " + device->getName();
+        }
+        return r;
+    }
+
+    /**
+     * @brief Returns the ring position of an absolute bucket index (non-negative for any index).
+     */
+    size_t slotOf(int64_t index) const {
+        int64_t slot = index % static_cast<int64_t>(bucketCount);
+        return static_cast<size_t>(slot < 0 ? slot + static_cast<int64_t>(bucketCount) : slot);
+    }
+
+    /**
+     * @brief Returns the ring slot for an absolute bucket, recycling stale slots.
+     * @return The slot, or nullptr if the bucket is older than the slot's contents
+     */
+    Bucket* bucketAt(int id, int64_t index) {
+        Bucket& b = buckets[static_cast<size_t>(id) * bucketCount + slotOf(index)];
+        if (b.index > index) return nullptr;
+        if (b.index != index) b = Bucket{index, 0, 0};
+        return &b;
+    }
+
+    /**
+     * @brief Adds a finished ON interval to the totals and the retained buckets.
+     */
+    void closeInterval(int id, DeviceRollup& r, SimTime now) {
+        if (now <= r.onSince) return;  // Time was reset under an open interval
+        r.onTime += now - r.onSince;
+
+        int64_t lastBucket = (now - 1) / bucketWidth;
+        int64_t firstBucket = std::max<int64_t>(r.onSince / bucketWidth, lastBucket - bucketCount + 1);
+        for (int64_t b = firstBucket; b <= lastBucket; ++b) {
+            SimTime from = std::max(r.onSince, b * bucketWidth);
+            SimTime to = std::min(now, (b + 1) * bucketWidth);
+            Bucket* slot = bucketAt(id, b);
+            if (slot) slot->onTime += to - from;
+        }
+    }
+};
+
+#endif // ACTIVITY_ROLLUP_H
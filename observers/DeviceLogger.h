@@ -6,9 +6,17 @@
  * the state of smart devices. When devices are toggled on or off, this logger receives
  * notifications and outputs them to both the console and an internal log list.
  *
+ * Log entries are stored as compact records and indexed per device and per device
+ * type, so range queries ("all transitions of Bedroom Fan between t=1000 and
+ * t=5000") cost O(log n + k) in the number of matching entries k rather than a scan
+ * over the whole log. Each index is a list of time-ordered runs: records are always
+ * appended, and a record older than the one before it (after a simulation reset)
+ * starts a new run, so logging stays O(1) and a query searches each run.
+ *
  * This class supports:
  * - Console logging of state changes
  * - Viewing all logged actions via a CLI command
+ * - Querying a device or device type over a time range
  *
  * Design Pattern:
  * - Observer Pattern: This class observes `SmartDevice` instances for state changes.
@@ -19,28 +27,70 @@
 
 #include "Observer.h"
 #include "../models/SmartDevice.h"
+#include "../utils/SimClock.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 class DeviceLogger : public Observer {
 private:
-    std::vector<std::string> logs;  ///< Stores string logs of device activity
+    /**
+     * @brief One logged state transition.
+     */
+    struct LogRecord {
+        SimTime time;  ///< Simulated time of the transition
+        int device;    ///< Logger-local device slot (see `devices`)
+        bool on;       ///< New state
+    };
+
+    /**
+     * @brief Record positions split into runs, each ordered by time.
+     */
+    using RecordIndex = std::vector<std::vector<uint32_t>>;
+
+    /**
+     * @brief Name and type of a device seen by the logger, with its record index.
+     */
+    struct DeviceEntry {
+        std::string name;
+        int type = -1;                   ///< Index into `types`
+        RecordIndex records;             ///< Positions in `logs`
+    };
+
+    /**
+     * @brief A device type and the index of its records.
+     */
+    struct TypeEntry {
+        std::string name;
+        RecordIndex records;
+    };
+
+    std::vector<LogRecord> logs;                        ///< All records in arrival order
+    std::vector<DeviceEntry> devices;                   ///< Indexed by logger device slot
+    std::vector<TypeEntry> types;                       ///< Known device types
+    std::vector<int> slotById;                          ///< Device handle -> logger slot
+    std::unordered_map<std::string, int> slotByName;    ///< Device name -> logger slot
 
 public:
     /**
      * @brief Called when an observed device's state changes.
-     * Logs the new state both to the console and to the internal log list.
+     * Logs the new state both to the console and to the indexed record store.
      *
      * @param device Pointer to the smart device that triggered the update
      */
     void update(SmartDevice* device) override {
-        std::string logEntry = "[Logger] " + device->getType() + " \"" +
-                               device->getName() + "\" is now " +
-                               (device->getState() ? "ON" : "OFF") + "\n";
+        int slot = slotFor(device);
+        uint32_t pos = static_cast<uint32_t>(logs.size());
+        logs.push_back(LogRecord{SimClock::now(), slot, device->getState()});
+
+        append(devices[slot].records, pos);
+        append(types[devices[slot].type].records, pos);
 
-        std::cout << logEntry;
-        logs.push_back(logEntry);  // Store for later review
+        std::cout << format(logs.back());
     }
 
     /**
@@ -55,10 +105,95 @@ public:
 
         std::cout << "\n===== Device Activity Log =====\n";
         for (const auto& entry : logs) {
-            std::cout << entry;
+            std::cout << format(entry);
         }
         std::cout << "================================\n";
     }
+
+    /**
+     * @brief Prints the transitions of one device or device type within a time range.
+     *
+     * The target is matched against device names first, then device types.
+     * Called by the "logs <device> [--from t] [--to t]" command in the CLI.
+     *
+     * @param target Device name or device type (e.g., "Bedroom Fan" or "Fan")
+     * @param from Start of the range (inclusive)
+     * @param to End of the range (inclusive)
+     */
+    void printQuery(const std::string& target, SimTime from = std::numeric_limits<SimTime>::min(),
+                    SimTime to = std::numeric_limits<SimTime>::max()) const {
+        const RecordIndex* index = nullptr;
+        auto it = slotByName.find(target);
+        if (it != slotByName.end()) {
+            index = &devices[it->second].records;
+        } else {
+            for (const auto& t : types) {
+                if (t.name == target) index = &t.records;
+            }
+        }
+        if (!index) {
+            std::cout << "[Logger] No actions logged for \"" << target << "\".\n";
+            return;
+        }
+
+        std::cout << "\n===== Device Activity: " << target << " =====\n";
+        long long matches = 0;
+        for (const auto& run : *index) {
+            auto first = std::lower_bound(run.begin(), run.end(), from,
+                [this](uint32_t pos, SimTime t) { return logs[pos].time < t; });
+            auto last = std::upper_bound(first, run.end(), to,
+                [this](SimTime t, uint32_t pos) { return t < logs[pos].time; });
+            for (auto p = first; p != last; ++p) {
+                std::cout << "t=" << SimClock::format(logs[*p].time) << " " << format(logs[*p]);
+            }
+            matches += last - first;
+        }
+        std::cout << "[Logger] " << matches << " matching entries.\n";
+        std::cout << "================================\n";
+    }
+
+private:
+    /**
+     * @brief Returns the logger slot for a device, registering it on first sight.
+     */
+    int slotFor(SmartDevice* device) {
+        int id = device->getId();
+        if (id >= static_cast<int>(slotById.size())) slotById.resize(id + 1, -1);
+        if (slotById[id] >= 0) return slotById[id];
+
+        std::string type = device->getType();
+        int typeIndex = -1;
+        for (size_t i = 0; i < types.size(); ++i) {
+            if (types[i].name == type) typeIndex = static_cast<int>(i);
+        }
+        if (typeIndex < 0) {
+            typeIndex = static_cast<int>(types.size());
+            types.push_back(TypeEntry{type, {}});
+        }
+
+        int slot = static_cast<int>(devices.size());
+        devices.push_back(DeviceEntry{device->getName(), typeIndex, {}});
+        slotById[id] = slot;
+        slotByName[device->getName()] = slot;
+        return slot;
+    }
+
+    /**
+     * @brief Appends a record position to an index, starting a new run if time went backwards.
+     */
+    void append(RecordIndex& index, uint32_t pos) {
+        if (index.empty() || logs[index.back().back()].time > logs[pos].time) index.emplace_back();
+        index.back().push_back(pos);
+    }
+
+    /**
+     * @brief Formats a record the way it is echoed to the console.
+     */
+    std::string format(const LogRecord& r) const {
+        const DeviceEntry& d = devices[r.device];
+        return "[Logger] " + types[d.type].name + " \"" + d.name + "\" is now " +
+               (r.on ? "ON" : "OFF") + "\n";
+    }
 };
 
 #endif // DEVICE_LOGGER_H
@@ -2,12 +2,19 @@
 #define OBSERVER_H
 
 #include <string>
+#include <vector>
 
 class SmartDevice;
 
 class Observer {
 public:
     virtual void update(SmartDevice* device) = 0;
+
+    // Receives all devices changed in one notification batch; override to handle them at once
+    virtual void updateBatch(const std::vector<SmartDevice*>& devices) {
+        for (auto* d : devices) update(d);
+    }
+
     virtual ~Observer() {}
 };
 
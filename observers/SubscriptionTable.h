@@ -0,0 +1,215 @@
+/**
+ * @file SubscriptionTable.h
+ * @brief Central registry of observer subscriptions for all smart devices.
+ *
+ * The `SubscriptionTable` class replaces the per-device observer vectors. It keeps
+ * three kinds of subscriptions:
+ * - Global: one entry that observes every device (e.g., the logger)
+ * - Per type: one entry per (device type, observer) pair
+ * - Per device: stored in a compressed sparse row (CSR) layout, i.e. one
+ *   contiguous array of observers plus an offset array indexed by device handle
+ *
+ * New per-device subscriptions are staged and merged into the CSR arrays lazily on
+ * the next delivery, so fan-out is always a tight loop over contiguous memory.
+ *
+ * Design Pattern:
+ * - Observer Pattern: This class is the shared subject-side registry that routes
+ *   device state changes to `Observer` instances.
+ */
+
+#ifndef SUBSCRIPTION_TABLE_H
+#define SUBSCRIPTION_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Observer.h"
+
+class SmartDevice;
+
+class SubscriptionTable {
+    std::vector<Observer*> global;                    ///< Observers of every device
+    std::vector<std::string> typeNames;               ///< Known device types
+    std::vector<std::vector<Observer*>> byType;       ///< Observers per type (parallel to typeNames)
+    std::vector<int16_t> deviceType;                  ///< Device handle -> type index (-1 = unknown)
+    std::vector<uint32_t> offsets{0};                 ///< CSR row offsets, size = devices + 1
+    std::vector<Observer*> entries;                   ///< CSR observer entries
+    std::vector<std::pair<int, Observer*>> staged;    ///< Per-device subscriptions not yet merged
+
+public:
+    /**
+     * @brief Returns the table shared by all devices.
+     */
+    static SubscriptionTable& instance() {
+        static SubscriptionTable table;
+        return table;
+    }
+
+    /**
+     * @brief Subscribes an observer to every device, current and future.
+     * @param o Pointer to an Observer instance
+     */
+    void subscribeAll(Observer* o) { global.push_back(o); }
+
+    /**
+     * @brief Subscribes an observer to every device of a type (e.g., "Fan").
+     * @param type Device type as returned by SmartDevice::getType()
+     * @param o Pointer to an Observer instance
+     */
+    void subscribeType(const std::string& type, Observer* o) {
+        byType[typeIndex(type)].push_back(o);
+    }
+
+    /**
+     * @brief Subscribes an observer to a single device.
+     * @param deviceId Handle of the device
+     * @param o Pointer to an Observer instance
+     */
+    void subscribe(int deviceId, Observer* o) { staged.push_back({deviceId, o}); }
+
+    /**
+     * @brief Returns whether the type of a device still needs to be registered.
+     */
+    bool needsType(int deviceId) const {
+        return deviceId >= static_cast<int>(deviceType.size()) || deviceType[deviceId] < 0;
+    }
+
+    /**
+     * @brief Records the type of a device so type subscriptions can reach it.
+     * @param deviceId Handle of the device
+     * @param type Device type as returned by SmartDevice::getType()
+     */
+    void setDeviceType(int deviceId, const std::string& type) {
+        if (deviceId >= static_cast<int>(deviceType.size())) deviceType.resize(deviceId + 1, -1);
+        deviceType[deviceId] = static_cast<int16_t>(typeIndex(type));
+    }
+
+    /**
+     * @brief Delivers one device change to every matching observer.
+     * @param deviceId Handle of the changed device
+     * @param device Pointer passed on to Observer::update
+     * @return Number of observer calls made
+     */
+    int publish(int deviceId, SmartDevice* device) {
+        if (!staged.empty()) mergeStaged();
+        int calls = 0;
+        for (auto* o : global) {
+            o->update(device);
+            calls++;
+        }
+        for (auto* o : byType[deviceType[deviceId]]) {
+            o->update(device);
+            calls++;
+        }
+        if (deviceId + 1 < static_cast<int>(offsets.size())) {
+            for (uint32_t i = offsets[deviceId]; i < offsets[deviceId + 1]; ++i) {
+                entries[i]->update(device);
+                calls++;
+            }
+        }
+        return calls;
+    }
+
+    /**
+     * @brief Delivers a batch of changes with one updateBatch() call per observer.
+     * @param devices Changed devices, in the order they first changed
+     * @param ids Handles of `devices` (parallel array)
+     * @return Number of observer calls made
+     */
+    int publishBatch(const std::vector<SmartDevice*>& devices, const std::vector<int>& ids) {
+        if (!staged.empty()) mergeStaged();
+        int calls = 0;
+        for (auto* o : global) {
+            o->updateBatch(devices);
+            calls++;
+        }
+
+        std::vector<SmartDevice*> subset;
+        for (size_t t = 0; t < byType.size(); ++t) {
+            if (byType[t].empty()) continue;
+            subset.clear();
+            for (size_t i = 0; i < devices.size(); ++i) {
+                if (deviceType[ids[i]] == static_cast<int16_t>(t)) subset.push_back(devices[i]);
+            }
+            if (subset.empty()) continue;
+            for (auto* o : byType[t]) {
+                o->updateBatch(subset);
+                calls++;
+            }
+        }
+
+        std::vector<std::pair<Observer*, std::vector<SmartDevice*>>> perObserver;
+        for (size_t i = 0; i < devices.size(); ++i) {
+            int id = ids[i];
+            if (id + 1 >= static_cast<int>(offsets.size())) continue;
+            for (uint32_t e = offsets[id]; e < offsets[id + 1]; ++e) {
+                size_t k = 0;
+                while (k < perObserver.size() && perObserver[k].first != entries[e]) k++;
+                if (k == perObserver.size()) perObserver.push_back({entries[e], {}});
+                perObserver[k].second.push_back(devices[i]);
+            }
+        }
+        for (auto& [o, list] : perObserver) {
+            o->updateBatch(list);
+            calls++;
+        }
+        return calls;
+    }
+
+    /**
+     * @brief Approximate heap bytes used by the table.
+     */
+    size_t memoryBytes() const {
+        size_t bytes = global.capacity() * sizeof(Observer*)
+                     + deviceType.capacity() * sizeof(int16_t)
+                     + offsets.capacity() * sizeof(uint32_t)
+                     + entries.capacity() * sizeof(Observer*)
+                     + staged.capacity() * sizeof(std::pair<int, Observer*>);
+        for (const auto& t : byType) bytes += t.capacity() * sizeof(Observer*);
+        return bytes;
+    }
+
+private:
+    /**
+     * @brief Returns the index of a device type, adding it if new.
+     */
+    int typeIndex(const std::string& type) {
+        for (size_t i = 0; i < typeNames.size(); ++i) {
+            if (typeNames[i] == type) return static_cast<int>(i);
+        }
+        typeNames.push_back(type);
+        byType.emplace_back();
+        return static_cast<int>(typeNames.size() - 1);
+    }
+
+    /**
+     * @brief Rebuilds the CSR arrays with the staged subscriptions merged in.
+     * Existing entries keep their order; staged ones follow in subscription order.
+     */
+    void mergeStaged() {
+        size_t rows = offsets.size() - 1;
+        for (const auto& s : staged) {
+            if (static_cast<size_t>(s.first) + 1 > rows) rows = s.first + 1;
+        }
+
+        std::vector<uint32_t> newOffsets(rows + 1, 0);
+        for (size_t r = 0; r + 1 < offsets.size(); ++r) newOffsets[r + 1] = offsets[r + 1] - offsets[r];
+        for (const auto& s : staged) newOffsets[s.first + 1]++;
+        for (size_t r = 0; r < rows; ++r) newOffsets[r + 1] += newOffsets[r];
+
+        std::vector<Observer*> newEntries(newOffsets[rows]);
+        std::vector<uint32_t> fill(newOffsets.begin(), newOffsets.end() - 1);
+        for (size_t r = 0; r + 1 < offsets.size(); ++r) {
+            for (uint32_t i = offsets[r]; i < offsets[r + 1]; ++i) newEntries[fill[r]++] = entries[i];
+        }
+        for (const auto& s : staged) newEntries[fill[s.first]++] = s.second;
+
+        offsets.swap(newOffsets);
+        entries.swap(newEntries);
+        staged.clear();
+        staged.shrink_to_fit();
+    }
+};
+
+#endif // SUBSCRIPTION_TABLE_H
@@ -0,0 +1,414 @@
+/**
+ * @file WriteAheadLog.h
+ * @brief Observer that makes device state transitions durable in SmartHomeSim.
+ *
+ * The `WriteAheadLog` class implements the Observer interface and appends one
+ * record per device state change to an on-disk log. Records are buffered and
+ * flushed with group commit: every transition that arrives within the batch
+ * window shares a single `fsync`. On startup the log is replayed on top of the
+ * last snapshot so device states survive a crash or restart.
+ *
+ * This class supports:
+ * - Appending state transitions as they are notified
+ * - Group commit with a configurable batch window
+ * - Checkpointing all device states into a snapshot and truncating the log
+ * - Recovery (snapshot + log replay) at startup
+ * - Commit latency and throughput statistics
+ *
+ * Design Pattern:
+ * - Observer Pattern: This class observes `SmartDevice` instances for state changes.
+ */
+
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include "Observer.h"
+#include "../models/SmartDevice.h"
+#include "../utils/SimClock.h"
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+class WriteAheadLog : public Observer {
+public:
+    /**
+     * @brief Counters describing commit behavior since startup.
+     */
+    struct Stats {
+        long long records = 0;         ///< Records made durable
+        long long commits = 0;         ///< Number of fsync-backed commits
+        long long totalLatencyUs = 0;  ///< Sum of first-append-to-durable latencies
+        long long maxLatencyUs = 0;    ///< Worst single commit latency
+        long long totalSyncUs = 0;     ///< Time spent inside write + fsync
+    };
+
+    /**
+     * @brief Resolves a recovered record to a device, creating it if needed.
+     * Receives the device type and name; returns nullptr to skip the record.
+     */
+    using DeviceResolver = std::function<SmartDevice*(const std::string&, const std::string&)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string logPath;                   ///< Path of the append-only log file
+    std::string snapshotPath;              ///< Path of the last checkpoint snapshot
+    int fd = -1;                           ///< Open log file descriptor
+    std::string pending;                   ///< Encoded records awaiting commit
+    int pendingRecords = 0;                ///< Number of records in `pending`
+    std::uintmax_t committedBytes = 0;     ///< Log length covered by successful commits
+    long long nextLsn = 1;                 ///< Log sequence number of the next record
+    long long windowUs;                    ///< Group commit window (microseconds)
+    Clock::time_point batchStart;          ///< Arrival time of the oldest pending record
+    Stats stats;                           ///< Commit statistics
+
+    static constexpr size_t maxBatchBytes = 1 << 20;  ///< Force a commit past this size
+
+public:
+    /**
+     * @brief Opens (or creates) the log files.
+     * @param logFile Path of the write-ahead log
+     * @param snapshotFile Path of the checkpoint snapshot
+     * @param batchWindowUs Group commit window in microseconds (0 = commit every record)
+     */
+    WriteAheadLog(const std::string& logFile, const std::string& snapshotFile, long long batchWindowUs = 2000)
+        : logPath(logFile), snapshotPath(snapshotFile), windowUs(batchWindowUs) {}
+
+    /**
+     * @brief Flushes any pending records and closes the log.
+     */
+    ~WriteAheadLog() override {
+        sync();
+        closeLog();
+    }
+
+    /**
+     * @brief Called when an observed device's state changes.
+     * Appends a transition record and commits if the batch window has elapsed.
+     *
+     * @param device Pointer to the smart device that triggered the update
+     */
+    void update(SmartDevice* device) override {
+        if (pendingRecords == 0) batchStart = Clock::now();
+
+        pending += std::to_string(nextLsn++);
+        pending += ' ';
+        pending += std::to_string(SimClock::now());
+        pending += device->getState() ? " 1 " : " 0 ";
+        pending += device->getType();
+        pending += ' ';
+        pending += device->getName();
+        pending += '\n';
+        pendingRecords++;
+
+        commitIfDue();
+    }
+
+    /**
+     * @brief Commits the pending batch if its window has elapsed or it is too large.
+     * A failed commit keeps the batch; the next commit retries it.
+     */
+    void commitIfDue() {
+        if (pendingRecords == 0) return;
+        long long waited = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - batchStart).count();
+        if (waited >= windowUs || pending.size() >= maxBatchBytes) commit();
+    }
+
+    /**
+     * @brief Forces all pending records to disk regardless of the batch window.
+     * Called by the CLI before it acknowledges a command.
+     * @return false if the records could not be made durable (they stay pending);
+     *         the caller must not acknowledge them
+     */
+    bool sync() {
+        return pendingRecords == 0 || commit();
+    }
+
+    /**
+     * @brief Changes the group commit window.
+     * @param us New window in microseconds
+     */
+    void setBatchWindow(long long us) { windowUs = us; }
+
+    /**
+     * @brief Returns the group commit window.
+     * @return Window in microseconds
+     */
+    long long getBatchWindow() const { return windowUs; }
+
+    /**
+     * @brief Returns the commit statistics collected so far.
+     */
+    const Stats& getStats() const { return stats; }
+
+    /**
+     * @brief Replays the snapshot and the log to restore device states.
+     *
+     * The snapshot is applied first, then every log record with a newer sequence
+     * number. A snapshot with a corrupt header is ignored and the whole log is
+     * replayed. A torn final record (from a crash mid-write) is discarded and cut
+     * from the file so new records append cleanly. Must be called before the log
+     * is subscribed to devices.
+     *
+     * @param resolve Callback mapping a (type, name) pair to a device
+     * @return Number of log records replayed
+     */
+    int recover(const DeviceResolver& resolve) {
+        long long snapshotLsn = 0;
+        std::ifstream snap(snapshotPath);
+        std::string line;
+        if (snap && std::getline(snap, line) && line.rfind("snapshot ", 0) == 0
+            && parseLsn(std::string_view(line).substr(9), snapshotLsn)) {
+            while (std::getline(snap, line)) {
+                std::istringstream in(line);
+                int state;
+                std::string type, name;
+                if (!(in >> state >> type) || !std::getline(in >> std::ws, name)) break;
+                if (SmartDevice* d = resolve(type, name)) d->restoreState(state != 0);
+            }
+        }
+        nextLsn = snapshotLsn + 1;
+
+        int replayed = 0;
+        std::uintmax_t validBytes = 0;
+        std::ifstream log(logPath, std::ios::binary);
+        while (log && std::getline(log, line)) {
+            if (log.eof()) break;  // No trailing newline: torn record
+            std::istringstream in(line);
+            long long lsn;
+            long long time;
+            int state;
+            std::string type, name;
+            if (!(in >> lsn >> time >> state >> type) || !std::getline(in >> std::ws, name)) break;
+            validBytes += line.size() + 1;
+            if (lsn >= nextLsn) nextLsn = lsn + 1;
+            if (lsn <= snapshotLsn) continue;
+            if (SmartDevice* d = resolve(type, name)) {
+                d->restoreState(state != 0);
+                replayed++;
+            }
+        }
+        log.close();
+
+        std::error_code ec;
+        if (std::filesystem::exists(logPath, ec) && std::filesystem::file_size(logPath, ec) > validBytes)
+            std::filesystem::resize_file(logPath, validBytes, ec);
+
+        openLog(false);
+        committedBytes = validBytes;
+        return replayed;
+    }
+
+    /**
+     * @brief Writes a snapshot of all device states and truncates the log.
+     *
+     * The snapshot is written to a temporary file, synced, renamed into place and
+     * the rename synced (through the directory) before the log is truncated, so a
+     * crash at any point leaves a recoverable pair. Nothing is written while
+     * records cannot be committed.
+     *
+     * @param devices All devices whose state should be captured
+     */
+    void checkpoint(const std::vector<SmartDevice*>& devices) {
+        if (!sync()) {
+            std::cout << "[WAL] Checkpoint skipped: pending records are not durable.\n";
+            return;
+        }
+        std::string body = "snapshot " + std::to_string(nextLsn - 1) + "\n";
+        for (const auto* d : devices) {
+            body += d->getState() ? "1 " : "0 ";
+            body += d->getType() + " " + d->getName() + "\n";
+        }
+
+        std::string tmpPath = snapshotPath + ".tmp";
+        int snapFd = openFile(tmpPath, true);
+        if (snapFd < 0 || !writeAll(snapFd, body) || !syncFile(snapFd)) {
+            std::cout << "[WAL] Checkpoint failed: cannot write " << tmpPath << "\n";
+            if (snapFd >= 0) closeFile(snapFd);
+            return;
+        }
+        closeFile(snapFd);
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, snapshotPath, ec);
+        if (ec) {
+            std::cout << "[WAL] Checkpoint failed: " << ec.message() << "\n";
+            return;
+        }
+        if (!syncDirectory(snapshotPath)) {
+            std::cout << "[WAL] Checkpoint failed: cannot sync the directory of " << snapshotPath << "\n";
+            return;
+        }
+        closeLog();
+        openLog(true);
+        committedBytes = 0;
+        std::cout << "[WAL] Checkpoint written (" << devices.size() << " devices, lsn "
+                  << nextLsn - 1 << ").\n";
+    }
+
+    /**
+     * @brief Prints commit latency and throughput statistics.
+     */
+    void printStats() const {
+        std::cout << "\n===== Write-Ahead Log =====\n";
+        std::cout << "Batch window:      " << windowUs << " us\n";
+        std::cout << "Records committed: " << stats.records << "\n";
+        std::cout << "Commits (fsync):   " << stats.commits << "\n";
+        if (stats.commits > 0) {
+            std::cout << "Records/commit:    " << static_cast<double>(stats.records) / stats.commits << "\n";
+            std::cout << "Avg latency:       " << stats.totalLatencyUs / stats.commits << " us\n";
+            std::cout << "Max latency:       " << stats.maxLatencyUs << " us\n";
+        }
+        if (stats.totalSyncUs > 0) {
+            std::cout << "Throughput:        " << stats.records * 1000000 / stats.totalSyncUs
+                      << " records/s of I/O time\n";
+        }
+        std::cout << "===========================\n";
+    }
+
+private:
+    /**
+     * @brief Writes the pending batch and fsyncs it as a single group commit.
+     *
+     * On failure the log is cut back to the last committed length, so no torn
+     * record hides later ones from recover(), and the batch stays pending.
+     *
+     * @return true if the batch is durable
+     */
+    bool commit() {
+        if (fd < 0) openLog(false);
+        Clock::time_point ioStart = Clock::now();
+        if (fd < 0 || !writeAll(fd, pending) || !syncFile(fd)) {
+            std::cout << "[WAL] Error: failed to persist " << pendingRecords << " records; will retry.\n";
+            if (fd >= 0 && !truncateFile(fd, committedBytes)) {
+                // The log cannot be repaired in place; reopen it on the next attempt
+                closeLog();
+                std::error_code ec;
+                std::filesystem::resize_file(logPath, committedBytes, ec);
+            }
+            return false;
+        }
+        Clock::time_point done = Clock::now();
+        committedBytes += pending.size();
+
+        long long latency = std::chrono::duration_cast<std::chrono::microseconds>(done - batchStart).count();
+        stats.records += pendingRecords;
+        stats.commits++;
+        stats.totalLatencyUs += latency;
+        if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+        stats.totalSyncUs += std::chrono::duration_cast<std::chrono::microseconds>(done - ioStart).count();
+
+        pending.clear();
+        pendingRecords = 0;
+        return true;
+    }
+
+    /**
+     * @brief Opens the log file for appending.
+     * @param truncate Whether to discard existing contents
+     */
+    void openLog(bool truncate) {
+        fd = openFile(logPath, truncate);
+        if (fd < 0) std::cout << "[WAL] Error: cannot open " << logPath << "\n";
+    }
+
+    /**
+     * @brief Closes the log file if it is open.
+     */
+    void closeLog() {
+        if (fd >= 0) closeFile(fd);
+        fd = -1;
+    }
+
+    /**
+     * @brief Parses a snapshot's sequence number; the whole text must be a non-negative number.
+     * @return false for a truncated or corrupt header
+     */
+    static bool parseLsn(std::string_view text, long long& lsn) {
+        while (!text.empty() && (text.back() == '\r' || text.back() == ' ')) text.remove_suffix(1);
+        long long value;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || end != text.data() + text.size() || value < 0) return false;
+        lsn = value;
+        return true;
+    }
+
+    static int openFile(const std::string& path, bool truncate) {
+        int flags = O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0);
+#ifdef _WIN32
+        return _open(path.c_str(), flags | _O_BINARY, 0644);
+#else
+        return ::open(path.c_str(), flags, 0644);
+#endif
+    }
+
+    static bool writeAll(int file, const std::string& data) {
+        size_t off = 0;
+        while (off < data.size()) {
+#ifdef _WIN32
+            int n = _write(file, data.data() + off, static_cast<unsigned>(data.size() - off));
+#else
+            ssize_t n = ::write(file, data.data() + off, data.size() - off);
+#endif
+            if (n <= 0) return false;
+            off += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static bool syncFile(int file) {
+#ifdef _WIN32
+        return _commit(file) == 0;
+#else
+        return ::fsync(file) == 0;
+#endif
+    }
+
+    static bool truncateFile(int file, std::uintmax_t length) {
+#ifdef _WIN32
+        return _chsize_s(file, static_cast<__int64>(length)) == 0;
+#else
+        return ::ftruncate(file, static_cast<off_t>(length)) == 0;
+#endif
+    }
+
+    /**
+     * @brief Makes a rename within the file's directory durable.
+     */
+    static bool syncDirectory(const std::string& path) {
+#ifdef _WIN32
+        (void)path;
+        return true;  // NTFS journals renames
+#else
+        std::string dir = std::filesystem::path(path).parent_path().string();
+        int dirFd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+        if (dirFd < 0) return false;
+        bool ok = ::fsync(dirFd) == 0;
+        ::close(dirFd);
+        return ok;
+#endif
+    }
+
+    static void closeFile(int file) {
+#ifdef _WIN32
+        _close(file);
+#else
+        ::close(file);
+#endif
+    }
+};
+
+#endif // WRITE_AHEAD_LOG_H
@@ -0,0 +1,52 @@
+/**
+ * @file AlignedAllocator.h
+ * @brief Standard allocator returning over-aligned memory for SIMD arrays.
+ *
+ * `AlignedAllocator<T, N>` lets `std::vector` store structure-of-arrays data on
+ * N-byte boundaries (32 bytes for AVX2), so vectorized kernels can use aligned
+ * loads and stores.
+ *
+ * Usage:
+ * std::vector<float, AlignedAllocator<float, 32>> thresholds;
+ */
+
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+template <typename T, std::size_t Alignment = 32>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+/**
+ * @brief Vector of T aligned for 256-bit SIMD loads.
+ */
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T, 32>>;
+
+#endif // ALIGNED_ALLOCATOR_H
@@ -0,0 +1,364 @@
+/**
+ * @file BinaryProtocol.h
+ * @brief Compact length-prefixed binary protocol for the control server.
+ *
+ * The `BinaryProtocol` class serves clients of a binary listener (see
+ * ControlServer). Where a text command names a device by string and takes
+ * several lines (`add`, `schedule`), a binary operation addresses devices by
+ * their numeric handle (SmartDevice::getId()) and is a few fixed-size fields.
+ * A client packs any number of operations into one frame:
+ *
+ *     request  = u32 length, then `length` bytes of operations
+ *     response = u32 length, then one 9-byte result per operation:
+ *                u8 status, i64 value
+ *
+ * All integers are little-endian and unaligned. Operations (the first byte is
+ * the opcode; the result value is given after the arrow):
+ *
+ *     GET      1  u32 device                         -> state (0/1)
+ *     SET      2  u32 device, u8 on                  -> state
+ *     TOGGLE   3  u32 device                         -> new state
+ *     ADD      4  u8 type, u8 n, n bytes of name     -> handle of the new device
+ *     SCHEDULE 5  u32 device, u8 on, u8 timing, i64 t -> task ID
+ *     CANCEL   6  u64 task ID                        -> 0
+ *     ADVANCE  7  i64 us                             -> simulated time after it (us)
+ *     ENERGY   8  u32 device (ALL_DEVICES = home)    -> energy used so far (mJ)
+ *
+ * Device types are 0 Light, 1 Fan, 2 Thermostat; timings are 0 at the absolute
+ * time t, 1 after a delay of t, 2 every t (all in us). An operation that is
+ * unknown or cut off by the end of the frame gets a MALFORMED result and ends
+ * the frame.
+ *
+ * Frames are decoded in place from the client's receive buffer: the parser
+ * only reads through a bounds-checked cursor and never copies a frame or
+ * builds a string per command (ADD copies its name once, into the device).
+ * Results are appended straight to the reply buffer and the length is
+ * patched in afterwards. A frame is one notification batch, settled once
+ * after its last operation, so a frame of N operations costs one round trip
+ * and one delivery instead of N of each.
+ *
+ * `FrameBuilder` and `parseResults()` are the client side of the format.
+ *
+ * Responsibilities:
+ * - Split a client's input into complete frames and reject oversized ones
+ * - Decode and execute the operations of each frame against the simulation
+ * - Encode one batched response frame per request frame
+ * - Build request frames and decode responses for clients
+ */
+
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ControlServer.h"
+#include "DeviceFactory.h"
+#include "SimClock.h"
+#include "../controllers/DeviceController.h"
+#include "../controllers/Scheduler.h"
+#include "../models/strategies/scheduling/DelayedSchedule.h"
+#include "../models/strategies/scheduling/OneTimeSchedule.h"
+#include "../models/strategies/scheduling/PeriodicSchedule.h"
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the binary protocol is read and written in host byte order");
+
+class BinaryProtocol {
+public:
+    enum Op : uint8_t { GET = 1, SET, TOGGLE, ADD, SCHEDULE, CANCEL, ADVANCE, ENERGY };
+
+    enum Status : uint8_t {
+        OK = 0,
+        NO_DEVICE = 1,   ///< No device has the handle
+        INVALID = 2,     ///< Bad or out-of-range argument, a task that never fires or was rejected, unknown task
+        MALFORMED = 3    ///< Unknown opcode or truncated operation; the rest of the frame is skipped
+    };
+
+    enum Timing : uint8_t { AT = 0, AFTER = 1, EVERY = 2 };
+
+    static constexpr uint32_t ALL_DEVICES = 0xFFFFFFFF;  ///< ENERGY target for the whole home
+    static constexpr uint32_t MAX_FRAME = 1 << 20;       ///< Longer frames close the connection
+    static constexpr size_t RESULT_SIZE = 9;
+
+    /**
+     * @brief Operations the protocol needs from the simulation loop.
+     */
+    struct Hooks {
+        std::function<void(SmartDevice*)> wire;       ///< Connects a newly added device (zones, sensors, ...)
+        std::function<void()> settle;                 ///< Delivers pending notifications
+        std::function<SimTime(SimTime)> advance;      ///< Advances simulated time by a duration, returns the new time
+    };
+
+    /**
+     * @brief One decoded result, on the client side.
+     */
+    struct Result {
+        uint8_t status;
+        int64_t value;
+    };
+
+private:
+    /**
+     * @brief Bounds-checked reader over a frame; never copies the frame.
+     */
+    class Cursor {
+        const char* p;
+        const char* end;
+
+    public:
+        explicit Cursor(std::string_view frame) : p(frame.data()), end(frame.data() + frame.size()) {}
+
+        bool done() const { return p == end; }
+
+        template <typename T>
+        bool read(T& v) {
+            if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+
+        bool bytes(size_t n, std::string_view& v) {
+            if (static_cast<size_t>(end - p) < n) return false;
+            v = std::string_view(p, n);
+            p += n;
+            return true;
+        }
+    };
+
+    DeviceController& controller;
+    Scheduler& scheduler;
+    Hooks hooks;
+
+public:
+    /**
+     * @brief Constructs the protocol over the simulation's controller and scheduler.
+     */
+    BinaryProtocol(DeviceController& c, Scheduler& s, Hooks h) : controller(c), scheduler(s), hooks(std::move(h)) {}
+
+    /**
+     * @brief Executes every complete frame of a client's input (a ControlServer handler).
+     *
+     * Operations are counted as the batch's commands; a partial frame is left
+     * for the next read.
+     */
+    void handle(ControlServer::Batch& batch) {
+        std::string_view in = batch.input;
+        size_t pos = 0;
+        while (in.size() - pos >= sizeof(uint32_t)) {
+            uint32_t length;
+            std::memcpy(&length, in.data() + pos, sizeof(length));
+            if (length > MAX_FRAME) {
+                batch.close = true;
+                break;
+            }
+            if (in.size() - pos - sizeof(length) < length) break;
+            batch.commands += execute(in.substr(pos + sizeof(length), length), *batch.output);
+            pos += sizeof(length) + length;
+        }
+        batch.consumed = pos;
+    }
+
+    /**
+     * @brief Executes one frame's operations and appends the response frame.
+     * @param frame Operations, without the length prefix
+     * @param out Reply buffer
+     * @return Number of operations executed (including a final malformed one)
+     */
+    int execute(std::string_view frame, std::string& out) {
+        size_t header = out.size();
+        out.append(sizeof(uint32_t), '\0');
+        Cursor in(frame);
+        int ops = 0;
+        while (!in.done()) {
+            ops++;
+            uint8_t op = 0;
+            in.read(op);
+            int64_t value = 0;
+            Status status = executeOne(static_cast<Op>(op), in, value);
+            appendResult(out, status, value);
+            if (status == MALFORMED) break;
+        }
+        uint32_t length = static_cast<uint32_t>(out.size() - header - sizeof(uint32_t));
+        std::memcpy(&out[header], &length, sizeof(length));
+        hooks.settle();
+        return ops;
+    }
+
+    /**
+     * @brief Decodes the complete response frames at the start of `in` (client side).
+     * @param in Received bytes
+     * @param results Receives the results of every complete frame, in order
+     * @return Bytes consumed
+     */
+    static size_t parseResults(std::string_view in, std::vector<Result>& results) {
+        size_t pos = 0;
+        while (in.size() - pos >= sizeof(uint32_t)) {
+            uint32_t length;
+            std::memcpy(&length, in.data() + pos, sizeof(length));
+            if (in.size() - pos - sizeof(length) < length) break;
+            Cursor frame(in.substr(pos + sizeof(length), length));
+            Result r;
+            while (frame.read(r.status) && frame.read(r.value)) results.push_back(r);
+            pos += sizeof(length) + length;
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Builds request frames (client side).
+     */
+    class FrameBuilder {
+        std::string buffer;
+        size_t header = 0;
+
+    public:
+        /**
+         * @brief Starts a frame; operations added until end() go into it.
+         */
+        void begin() {
+            header = buffer.size();
+            buffer.append(sizeof(uint32_t), '\0');
+        }
+
+        /**
+         * @brief Finishes the frame by writing its length.
+         */
+        void end() {
+            uint32_t length = static_cast<uint32_t>(buffer.size() - header - sizeof(uint32_t));
+            std::memcpy(&buffer[header], &length, sizeof(length));
+        }
+
+        void get(uint32_t device) { put(GET); put(device); }
+        void set(uint32_t device, bool on) { put(SET); put(device); put(static_cast<uint8_t>(on)); }
+        void toggle(uint32_t device) { put(TOGGLE); put(device); }
+        void cancel(uint64_t task) { put(CANCEL); put(task); }
+        void advance(SimTime duration) { put(ADVANCE); put(duration); }
+        void energy(uint32_t device) { put(ENERGY); put(device); }
+
+        /**
+         * @brief Adds a device; names longer than 255 bytes are truncated.
+         */
+        void add(uint8_t type, std::string_view name) {
+            name = name.substr(0, 255);
+            put(ADD);
+            put(type);
+            put(static_cast<uint8_t>(name.size()));
+            buffer.append(name);
+        }
+
+        void schedule(uint32_t device, bool on, Timing timing, SimTime time) {
+            put(SCHEDULE);
+            put(device);
+            put(static_cast<uint8_t>(on));
+            put(static_cast<uint8_t>(timing));
+            put(time);
+        }
+
+        const std::string& data() const { return buffer; }
+        void clear() { buffer.clear(); }
+
+    private:
+        template <typename T>
+        void put(T v) { buffer.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+    };
+
+private:
+    static void appendResult(std::string& out, Status status, int64_t value) {
+        char bytes[RESULT_SIZE];
+        bytes[0] = static_cast<char>(status);
+        std::memcpy(bytes + 1, &value, sizeof(value));
+        out.append(bytes, sizeof(bytes));
+    }
+
+    SmartDevice* device(uint32_t handle) const {
+        return handle > static_cast<uint32_t>(INT32_MAX) ? nullptr : controller.getDeviceById(static_cast<int>(handle));
+    }
+
+    /**
+     * @brief Decodes the arguments of one operation and runs it.
+     * @param op Opcode (already read)
+     * @param in Cursor positioned after the opcode
+     * @param value Receives the result value
+     */
+    Status executeOne(Op op, Cursor& in, int64_t& value) {
+        uint32_t handle = 0;
+        uint8_t flag = 0;
+        switch (op) {
+            case GET:
+            case TOGGLE:
+            case SET: {
+                if (!in.read(handle) || (op == SET && !in.read(flag))) return MALFORMED;
+                SmartDevice* d = device(handle);
+                if (!d) return NO_DEVICE;
+                if (op == TOGGLE) d->toggle();
+                else if (op == SET) d->setState(flag != 0);
+                value = d->getState();
+                return OK;
+            }
+            case ADD: {
+                uint8_t type, length;
+                std::string_view name;
+                if (!in.read(type) || !in.read(length) || !in.bytes(length, name)) return MALFORMED;
+                static const char* const TYPES[] = {"Light", "Fan", "Thermostat"};
+                if (type >= 3 || name.empty()) return INVALID;
+                SmartDevice* d = DeviceFactory::createDevice(TYPES[type], std::string(name));
+                controller.addDevice(d);
+                hooks.wire(d);
+                value = d->getId();
+                return OK;
+            }
+            case SCHEDULE: {
+                uint8_t timing;
+                SimTime time;
+                if (!in.read(handle) || !in.read(flag) || !in.read(timing) || !in.read(time)) return MALFORMED;
+                SmartDevice* d = device(handle);
+                if (!d) return NO_DEVICE;
+                SchedulingStrategy* strategy = nullptr;
+                if (timing == AT) strategy = new OneTimeSchedule(time);
+                else if (timing == AFTER && time >= 0 && time <= std::numeric_limits<SimTime>::max() - SimClock::now()) strategy = new DelayedSchedule(SimClock::now() + time);
+                else if (timing == EVERY && time > 0) strategy = new PeriodicSchedule(time);
+                else return INVALID;
+                Scheduler::TaskId id = scheduler.addTask(d, flag != 0, strategy);
+                if (id == Scheduler::INVALID_TASK) return INVALID;
+                value = static_cast<int64_t>(id);
+                return OK;
+            }
+            case CANCEL: {
+                uint64_t id;
+                if (!in.read(id)) return MALFORMED;
+                return scheduler.cancel(id) ? OK : INVALID;
+            }
+            case ADVANCE: {
+                SimTime duration;
+                if (!in.read(duration)) return MALFORMED;
+                if (duration < 0 || duration > std::numeric_limits<SimTime>::max() - SimClock::now()) return INVALID;
+                hooks.settle();  // Earlier operations of the frame are delivered at the current instant
+                value = hooks.advance(duration);
+                return OK;
+            }
+            case ENERGY: {
+                if (!in.read(handle)) return MALFORMED;
+                const EnergyMeter& meter = SmartDevice::getEnergyMeter();
+                SimTime now = SimClock::now();
+                double joules;
+                if (handle == ALL_DEVICES) {
+                    joules = meter.homeTotals().energyAt(now);
+                } else {
+                    SmartDevice* d = device(handle);
+                    if (!d) return NO_DEVICE;
+                    joules = meter.deviceEnergy(d->getId(), now);
+                }
+                value = static_cast<int64_t>(joules * 1000.0 + 0.5);
+                return OK;
+            }
+        }
+        return MALFORMED;
+    }
+};
+
+#endif // BINARY_PROTOCOL_H
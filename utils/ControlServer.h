@@ -0,0 +1,446 @@
+/**
+ * @file ControlServer.h
+ * @brief Single-threaded epoll server for controlling the simulation over local sockets.
+ *
+ * The `ControlServer` class listens on a Unix domain socket and/or a localhost
+ * TCP port and multiplexes any number of clients on one epoll loop. Sockets are
+ * non-blocking: each wakeup reads whatever every ready client sent, hands the
+ * bytes to a handler that executes the complete commands in them (clients may
+ * pipeline), then calls a hook once before any reply is written (the caller
+ * uses it to make the whole wakeup's changes durable with one sync), and
+ * writes the replies. If the hook reports that the changes are not durable,
+ * the clients whose commands ran in that wakeup are closed unanswered. A client that does not read its replies only has its own
+ * reading paused once its reply buffer is full; nobody else waits for it. Reads
+ * per client and wakeup are capped so a streaming client cannot hold up the
+ * loop, and a client whose unexecuted input grows past a limit is closed.
+ *
+ * The server also counts commands and records their latency (from the read
+ * that delivered a command to the write that sent its reply) in a fixed-size
+ * log-scale histogram, reported as commands/s and percentiles.
+ *
+ * Each listener is either a text or a binary listener; batches from its
+ * clients carry that flag so one handler can serve both protocols.
+ *
+ * `OutputCapture` redirects an ostream (e.g., std::cout) into a client's reply
+ * buffer while a command runs, so the command set needs no changes to serve
+ * socket clients. Linux only.
+ *
+ * Responsibilities:
+ * - Accept Unix and TCP clients and run the epoll event loop
+ * - Buffer input per client and pass it to the command handler
+ * - Write replies without blocking, with per-client backpressure
+ * - Keep throughput and latency statistics
+ */
+
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <arpa/inet.h>
+#include <csignal>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+class ControlServer {
+public:
+    static constexpr size_t READ_CHUNK = 64 * 1024;
+    static constexpr size_t MAX_PENDING_OUTPUT = 1 << 20;  ///< Stop reading a client with this much unsent reply
+    static constexpr size_t MAX_READ_PER_WAKEUP = 256 * 1024;  ///< Bytes read from one client before others get a turn
+    static constexpr size_t MAX_PENDING_INPUT = 4 << 20;   ///< Unexecuted input (e.g., a line without newline) that closes a client
+
+    /**
+     * @brief Input of one client for one wakeup, and what the handler made of it.
+     */
+    struct Batch {
+        std::string_view input;   ///< Unconsumed bytes received from the client
+        std::string* output;      ///< Reply buffer to append to
+        size_t consumed = 0;      ///< Bytes of `input` the handler used (set by the handler)
+        int commands = 0;         ///< Commands executed (set by the handler)
+        bool close = false;       ///< Close the connection once the reply is sent
+        bool binary = false;      ///< The client connected through a binary listener
+    };
+
+    using Handler = std::function<void(Batch&)>;
+
+    /**
+     * @brief Redirects an ostream into a string for its lifetime.
+     */
+    class OutputCapture : public std::streambuf {
+        std::ostream& stream;
+        std::streambuf* saved;
+        std::string& target;
+
+    public:
+        OutputCapture(std::ostream& s, std::string& out) : stream(s), saved(s.rdbuf(this)), target(out) {}
+        ~OutputCapture() override { stream.rdbuf(saved); }
+
+    protected:
+        int_type overflow(int_type c) override {
+            if (c != traits_type::eof()) target.push_back(static_cast<char>(c));
+            return c;
+        }
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            target.append(s, static_cast<size_t>(n));
+            return n;
+        }
+    };
+
+    /**
+     * @brief Throughput and latency counters.
+     */
+    struct Stats {
+        static constexpr int SUB_BUCKETS = 8;             ///< Buckets per power of two
+        static constexpr int BUCKETS = 40 * SUB_BUCKETS;  ///< Covers 1 ns to ~18 minutes
+
+        long long connections = 0;
+        long long commands = 0;
+        long long wakeups = 0;
+        long long bytesIn = 0;
+        long long bytesOut = 0;
+        uint64_t histogram[BUCKETS] = {};
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+        /**
+         * @brief Records `count` commands that took `ns` nanoseconds each.
+         */
+        void record(uint64_t ns, int count) {
+            histogram[bucketOf(ns)] += static_cast<uint64_t>(count);
+        }
+
+        /**
+         * @brief Returns the upper bound in nanoseconds of the bucket holding the p-th percentile.
+         */
+        uint64_t percentile(double p) const {
+            uint64_t total = 0;
+            for (uint64_t n : histogram) total += n;
+            if (total == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total - 1)) + 1, seen = 0;
+            for (int b = 0; b < BUCKETS; ++b) {
+                seen += histogram[b];
+                if (seen >= rank) return upperBound(b);
+            }
+            return upperBound(BUCKETS - 1);
+        }
+
+    private:
+        static int bucketOf(uint64_t ns) {
+            if (ns < SUB_BUCKETS) return static_cast<int>(ns);
+            int exp = 63 - __builtin_clzll(ns);  // ns >= 2^exp, exp >= 3
+            int sub = static_cast<int>((ns >> (exp - 3)) & (SUB_BUCKETS - 1));
+            int b = (exp - 2) * SUB_BUCKETS + sub;
+            return b < BUCKETS ? b : BUCKETS - 1;
+        }
+        static uint64_t upperBound(int b) {
+            if (b < SUB_BUCKETS) return static_cast<uint64_t>(b);
+            int exp = b / SUB_BUCKETS + 2, sub = b % SUB_BUCKETS;
+            return (static_cast<uint64_t>(SUB_BUCKETS + sub + 1) << (exp - 3)) - 1;
+        }
+    };
+
+private:
+    struct Listener {
+        int fd;
+        bool binary;
+    };
+
+    struct Client {
+        int fd;
+        bool binary = false;                               ///< Accepted on a binary listener
+        std::string in;
+        std::string out;
+        size_t sent = 0;                                   ///< Bytes of `out` already written
+        bool closing = false;                              ///< Close once `out` is drained
+        bool reading = true;                               ///< EPOLLIN registered
+        bool writing = false;                              ///< EPOLLOUT registered
+        int unanswered = 0;                                ///< Commands whose reply is not fully sent
+        std::chrono::steady_clock::time_point receivedAt;  ///< Read time of the oldest unanswered command
+    };
+
+    int epollFd = -1;
+    std::vector<Listener> listeners;
+    std::vector<std::string> unixPaths;                    ///< Removed on destruction
+    std::unordered_map<int, std::unique_ptr<Client>> clients;
+    Stats stats;
+
+    static inline volatile std::sig_atomic_t stopRequested = 0;
+
+public:
+    ControlServer() { epollFd = epoll_create1(EPOLL_CLOEXEC); }
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    ~ControlServer() {
+        for (auto& [fd, c] : clients) ::close(fd);
+        for (const Listener& l : listeners) ::close(l.fd);
+        for (const std::string& path : unixPaths) ::unlink(path.c_str());
+        if (epollFd >= 0) ::close(epollFd);
+    }
+
+    /**
+     * @brief Listens on a Unix domain socket, replacing a stale socket file.
+     * @param path Socket path
+     * @param error Receives the reason on failure
+     * @param binary Serve the binary protocol instead of text commands
+     * @return true on success
+     */
+    bool listenUnix(const std::string& path, std::string& error, bool binary = false) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            error = "socket path too long";
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        ::unlink(path.c_str());
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (!bindAndListen(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr), binary, error)) return false;
+        unixPaths.push_back(path);
+        return true;
+    }
+
+    /**
+     * @brief Listens on 127.0.0.1 at a TCP port.
+     * @param port Port number
+     * @param error Receives the reason on failure
+     * @param binary Serve the binary protocol instead of text commands
+     * @return true on success
+     */
+    bool listenTcp(int port, std::string& error, bool binary = false) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        if (fd >= 0) ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        return bindAndListen(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr), binary, error);
+    }
+
+    /**
+     * @brief Runs the event loop until SIGINT or SIGTERM.
+     * @param handler Executes the complete commands in a client's input
+     * @param beforeReply Called once per wakeup after all handlers ran and before replies are written;
+     *        returns false if this wakeup's changes could not be made durable
+     */
+    void run(const Handler& handler, const std::function<bool()>& beforeReply) {
+        struct sigaction action{};
+        action.sa_handler = [](int) { stopRequested = 1; };
+        ::sigaction(SIGINT, &action, nullptr);
+        ::sigaction(SIGTERM, &action, nullptr);
+        ::signal(SIGPIPE, SIG_IGN);
+        stopRequested = 0;
+        stats.started = std::chrono::steady_clock::now();
+
+        std::vector<epoll_event> events(256);
+        std::vector<int> replied;  // Clients to flush, by descriptor (a flush may drop one)
+        std::vector<int> executed; // Clients whose commands ran in this wakeup
+        while (!stopRequested) {
+            int n = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            stats.wakeups++;
+            auto now = std::chrono::steady_clock::now();
+            replied.clear();
+            executed.clear();
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (const Listener* l = findListener(fd)) {
+                    accept(*l);
+                    continue;
+                }
+                auto it = clients.find(fd);
+                if (it == clients.end()) continue;
+                Client& c = *it->second;
+                int unanswered = c.unanswered;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) receive(c, handler, now);
+                if (c.unanswered > unanswered) executed.push_back(fd);
+                replied.push_back(fd);
+            }
+            if (replied.empty()) continue;
+            if (!beforeReply()) {
+                // Never acknowledge changes that did not reach the disk
+                for (int fd : executed) {
+                    auto it = clients.find(fd);
+                    if (it != clients.end()) drop(*it->second);
+                }
+            }
+            for (int fd : replied) {
+                auto it = clients.find(fd);
+                if (it != clients.end()) flush(*it->second);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the counters.
+     */
+    const Stats& getStats() const { return stats; }
+
+    /**
+     * @brief Prints connections, throughput and latency percentiles.
+     */
+    void printStats() const {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - stats.started).count();
+        std::cout << "\n===== Server Stats =====\n";
+        std::cout << "Connections: " << stats.connections << " (" << clients.size() << " open), wakeups: "
+                  << stats.wakeups << "\n";
+        std::cout << "Commands: " << stats.commands << " (" << std::fixed << std::setprecision(0)
+                  << (seconds > 0 ? stats.commands / seconds : 0.0) << "/s over " << std::setprecision(1)
+                  << seconds << " s)\n";
+        std::cout << "Bytes in/out: " << stats.bytesIn << " / " << stats.bytesOut << "\n";
+        std::cout << "Latency p50 / p90 / p99 / p99.9: " << std::setprecision(1)
+                  << stats.percentile(50) / 1e3 << " / " << stats.percentile(90) / 1e3 << " / "
+                  << stats.percentile(99) / 1e3 << " / " << stats.percentile(99.9) / 1e3 << " us\n";
+        std::cout << std::defaultfloat << std::setprecision(6) << "========================\n";
+    }
+
+private:
+    const Listener* findListener(int fd) const {
+        for (const Listener& l : listeners) {
+            if (l.fd == fd) return &l;
+        }
+        return nullptr;
+    }
+
+    bool bindAndListen(int fd, sockaddr* addr, socklen_t len, bool binary, std::string& error) {
+        if (fd < 0 || ::bind(fd, addr, len) < 0 || ::listen(fd, SOMAXCONN) < 0) {
+            error = std::strerror(errno);
+            if (fd >= 0) ::close(fd);
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        listeners.push_back(Listener{fd, binary});
+        return true;
+    }
+
+    void accept(const Listener& listener) {
+        while (true) {
+            int fd = ::accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;  // EAGAIN: accepted everything pending
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));  // Fails harmlessly on Unix sockets
+            auto c = std::make_unique<Client>();
+            c->fd = fd;
+            c->binary = listener.binary;
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+            clients[fd] = std::move(c);
+            stats.connections++;
+        }
+    }
+
+    /**
+     * @brief Reads what is available (up to MAX_READ_PER_WAKEUP) and runs the handler on it.
+     *
+     * Level-triggered epoll reports the client again if more is left. A client
+     * whose unexecuted input exceeds MAX_PENDING_INPUT is closed.
+     */
+    void receive(Client& c, const Handler& handler, std::chrono::steady_clock::time_point now) {
+        char buffer[READ_CHUNK];
+        for (size_t received = 0; received < MAX_READ_PER_WAKEUP;) {
+            ssize_t r = ::read(c.fd, buffer, sizeof(buffer));
+            if (r > 0) {
+                c.in.append(buffer, static_cast<size_t>(r));
+                stats.bytesIn += r;
+                received += static_cast<size_t>(r);
+                continue;
+            }
+            if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) c.closing = true;
+            if (r < 0 && errno == EINTR) continue;
+            break;
+        }
+        if (!c.in.empty()) {
+            Batch batch;
+            batch.input = c.in;
+            batch.output = &c.out;
+            batch.binary = c.binary;
+            handler(batch);
+            c.in.erase(0, batch.consumed);
+            if (batch.close || c.in.size() > MAX_PENDING_INPUT) {
+                c.closing = true;
+                c.in.clear();
+            }
+            if (batch.commands > 0) {
+                if (c.unanswered == 0) c.receivedAt = now;
+                c.unanswered += batch.commands;
+                stats.commands += batch.commands;
+            }
+        }
+    }
+
+    /**
+     * @brief Writes as much of the reply as the socket takes, then updates the interest set.
+     */
+    void flush(Client& c) {
+        while (c.sent < c.out.size()) {
+            ssize_t w = ::write(c.fd, c.out.data() + c.sent, c.out.size() - c.sent);
+            if (w > 0) {
+                c.sent += static_cast<size_t>(w);
+                stats.bytesOut += w;
+                continue;
+            }
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            drop(c);
+            return;
+        }
+        if (c.sent == c.out.size()) {
+            c.out.clear();
+            c.sent = 0;
+            if (c.unanswered > 0) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - c.receivedAt).count();
+                stats.record(static_cast<uint64_t>(ns), c.unanswered);
+                c.unanswered = 0;
+            }
+            if (c.closing) {
+                drop(c);
+                return;
+            }
+        }
+        bool wantWrite = !c.out.empty();
+        bool wantRead = !c.closing && c.out.size() - c.sent < MAX_PENDING_OUTPUT;
+        if (wantWrite != c.writing || wantRead != c.reading) {
+            epoll_event ev{};
+            ev.events = (wantRead ? static_cast<uint32_t>(EPOLLIN) : 0u) | (wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+            ev.data.fd = c.fd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+            c.writing = wantWrite;
+            c.reading = wantRead;
+        }
+    }
+
+    void drop(Client& c) {
+        int fd = c.fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        clients.erase(fd);
+    }
+};
+
+#endif // CONTROL_SERVER_H
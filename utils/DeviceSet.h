@@ -0,0 +1,124 @@
+/**
+ * @file DeviceSet.h
+ * @brief Bitset over device handles used for zone membership and device state.
+ *
+ * A `DeviceSet` stores one bit per device handle (see SmartDevice::getId()) in
+ * 64-bit words and grows on demand. Group operations (zone ∩ type, "which
+ * of these are on") are word-wise AND / AND-NOT, and iteration visits only set bits.
+ *
+ * Responsibilities:
+ * - Set, clear and test single devices in O(1)
+ * - Combine sets with word-wise operations
+ * - Iterate the set devices in handle order
+ */
+
+#ifndef DEVICE_SET_H
+#define DEVICE_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class DeviceSet {
+    std::vector<uint64_t> words;  ///< Bit i of word w = device handle w * 64 + i
+
+public:
+    /**
+     * @brief Adds a device handle to the set.
+     */
+    void set(int id) {
+        size_t w = static_cast<size_t>(id) / 64;
+        if (w >= words.size()) words.resize(w + 1, 0);
+        words[w] |= uint64_t(1) << (id % 64);
+    }
+
+    /**
+     * @brief Removes a device handle from the set.
+     */
+    void reset(int id) {
+        size_t w = static_cast<size_t>(id) / 64;
+        if (w < words.size()) words[w] &= ~(uint64_t(1) << (id % 64));
+    }
+
+    /**
+     * @brief Sets or clears a device handle.
+     */
+    void assign(int id, bool value) {
+        if (value) set(id);
+        else reset(id);
+    }
+
+    /**
+     * @brief Returns whether a device handle is in the set.
+     */
+    bool test(int id) const {
+        size_t w = static_cast<size_t>(id) / 64;
+        return w < words.size() && ((words[w] >> (id % 64)) & 1);
+    }
+
+    /**
+     * @brief Returns the bits of handles w * 64 .. w * 64 + 63 (0 past the end).
+     */
+    uint64_t word(size_t w) const { return w < words.size() ? words[w] : 0; }
+
+    /**
+     * @brief Returns the number of devices in the set.
+     */
+    size_t count() const {
+        size_t n = 0;
+        for (uint64_t w : words) n += static_cast<size_t>(__builtin_popcountll(w));
+        return n;
+    }
+
+    /**
+     * @brief Keeps only the devices also in `other`.
+     */
+    DeviceSet& operator&=(const DeviceSet& other) {
+        if (words.size() > other.words.size()) words.resize(other.words.size());
+        for (size_t w = 0; w < words.size(); ++w) words[w] &= other.words[w];
+        return *this;
+    }
+
+    /**
+     * @brief Adds every device in `other`.
+     */
+    DeviceSet& operator|=(const DeviceSet& other) {
+        if (words.size() < other.words.size()) words.resize(other.words.size(), 0);
+        for (size_t w = 0; w < other.words.size(); ++w) words[w] |= other.words[w];
+        return *this;
+    }
+
+    /**
+     * @brief Toggles membership of every device in `other` (symmetric difference).
+     */
+    DeviceSet& operator^=(const DeviceSet& other) {
+        if (words.size() < other.words.size()) words.resize(other.words.size(), 0);
+        for (size_t w = 0; w < other.words.size(); ++w) words[w] ^= other.words[w];
+        return *this;
+    }
+
+    /**
+     * @brief Removes every device in `other` (set difference).
+     */
+    DeviceSet& andNot(const DeviceSet& other) {
+        size_t n = words.size() < other.words.size() ? words.size() : other.words.size();
+        for (size_t w = 0; w < n; ++w) words[w] &= ~other.words[w];
+        return *this;
+    }
+
+    /**
+     * @brief Calls f(id) for every device in the set, in handle order.
+     */
+    template <typename F>
+    void forEach(F f) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t bits = words[w];
+            while (bits) {
+                f(static_cast<int>(w * 64 + __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+};
+
+#endif // DEVICE_SET_H
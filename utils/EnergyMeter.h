@@ -0,0 +1,331 @@
+/**
+ * @file EnergyMeter.h
+ * @brief Incremental energy accounting per device, per zone and for the home.
+ *
+ * The `EnergyMeter` class gives every device a wattage (a per-type default, or
+ * a per-device override) and integrates energy only when a device switches ON
+ * or OFF; nothing is scanned per tick. Switching OFF adds the closed interval's
+ * energy to the device. The home and every zone keep three running sums over
+ * their devices: closed energy, the power of the devices currently ON, and
+ * that power weighted by the instant each device switched ON. The energy at any
+ * instant is then
+ *
+ *     closed + power * now - weighted
+ *
+ * so the total of a device, a zone or the home is an O(1) query, and a
+ * transition touches one device plus the home and the zone chain above it.
+ *
+ * Per-device figures live in parallel arrays indexed by device handle, so a
+ * full report is one linear pass. Energy is kept in watt-seconds (joules) and
+ * shown in Wh/kWh.
+ *
+ * Responsibilities:
+ * - Keep per-type and per-device wattage
+ * - Integrate energy on ON/OFF transitions and wattage changes
+ * - Keep running totals for devices, zones (and their ancestors) and the home
+ * - Print totals and the per-device report for the `energy` commands
+ */
+
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SimClock.h"
+
+class EnergyMeter {
+public:
+    /**
+     * @brief Running sums of a group of devices (a zone or the home).
+     */
+    struct Totals {
+        double closed = 0.0;    ///< Energy of finished ON intervals (W*s)
+        double power = 0.0;     ///< Combined wattage of the devices currently ON (W)
+        double weighted = 0.0;  ///< Sum of wattage times switch-on instant (W*s)
+
+        /**
+         * @brief Returns the energy used up to `now` in watt-seconds.
+         */
+        double energyAt(SimTime now) const { return closed + power * SimClock::toSeconds(now) - weighted; }
+    };
+
+private:
+    // Per-device state, indexed by device handle
+    std::vector<uint8_t> tracked;      ///< Whether the device has been registered
+    std::vector<std::string> labels;   ///< "Type: Name"
+    std::vector<int16_t> typeOf;       ///< Index into typeNames
+    std::vector<uint8_t> customWatts;  ///< 1 = wattage set per device, 0 = type default
+    std::vector<double> watts;         ///< Current wattage
+    std::vector<SimTime> onSince;      ///< Start of the open ON interval (-1 = OFF)
+    std::vector<double> energy;        ///< Energy of finished ON intervals (W*s)
+    std::vector<int> zoneOf;           ///< Innermost zone (-1 = none)
+
+    std::vector<std::string> typeNames;
+    std::vector<double> typeWatts;     ///< Default wattage per type
+    std::vector<int> zoneParent;       ///< Zone index -> parent zone (-1 = top)
+    std::vector<Totals> zoneTotals;    ///< Per zone, covering its whole subtree
+    Totals home;                       ///< All devices
+
+public:
+    /**
+     * @brief Constructs a meter with default wattages for the built-in device types.
+     */
+    EnergyMeter() {
+        typeIndex("Light", 10.0);
+        typeIndex("Fan", 60.0);
+        typeIndex("Thermostat", 1500.0);
+    }
+
+    /**
+     * @brief Returns whether a device still needs to be registered.
+     */
+    bool needsDevice(int id) const {
+        return id >= static_cast<int>(tracked.size()) || !tracked[id];
+    }
+
+    /**
+     * @brief Registers a device (OFF, outside any zone) with its type's default wattage.
+     * @param id Device handle
+     * @param type Device type as returned by SmartDevice::getType()
+     * @param name Device name, for reports
+     */
+    void addDevice(int id, const std::string& type, const std::string& name) {
+        if (id >= static_cast<int>(tracked.size())) {
+            size_t n = static_cast<size_t>(id) + 1;
+            tracked.resize(n, 0);
+            labels.resize(n);
+            typeOf.resize(n, -1);
+            customWatts.resize(n, 0);
+            watts.resize(n, 0.0);
+            onSince.resize(n, -1);
+            energy.resize(n, 0.0);
+            zoneOf.resize(n, -1);
+        }
+        int t = typeIndex(type, 0.0);
+        tracked[id] = 1;
+        labels[id] = type + ": " + name;
+        typeOf[id] = static_cast<int16_t>(t);
+        watts[id] = typeWatts[t];
+    }
+
+    /**
+     * @brief Records an ON/OFF transition; repeating the current state does nothing.
+     * @param id Registered device handle
+     * @param on New state
+     * @param now Instant of the transition
+     */
+    void setState(int id, bool on, SimTime now) {
+        if (on == (onSince[id] >= 0)) return;
+        if (on) open(id, now);
+        else close(id, now);
+    }
+
+    /**
+     * @brief Declares a zone; zones must be added parents first.
+     * @param zone Zone index
+     * @param parent Parent zone index (-1 for the top)
+     */
+    void addZone(int zone, int parent) {
+        if (zone >= static_cast<int>(zoneParent.size())) {
+            zoneParent.resize(zone + 1, -1);
+            zoneTotals.resize(zone + 1);
+        }
+        zoneParent[zone] = parent;
+    }
+
+    /**
+     * @brief Moves a registered device into a zone.
+     *
+     * A device that is ON has its interval split at `now`, so energy used
+     * before the move stays with the old zone.
+     */
+    void moveDevice(int id, int zone, SimTime now) {
+        if (zoneOf[id] == zone) return;
+        bool on = onSince[id] >= 0;
+        if (on) close(id, now);
+        zoneOf[id] = zone;
+        if (on) open(id, now);
+    }
+
+    /**
+     * @brief Sets the wattage of one device.
+     * @return false if the device is not registered
+     */
+    bool setDeviceWatts(int id, double w, SimTime now) {
+        if (needsDevice(id)) return false;
+        customWatts[id] = 1;
+        rate(id, w, now);
+        return true;
+    }
+
+    /**
+     * @brief Sets the default wattage of a type and applies it to the type's
+     * devices that have no per-device wattage.
+     * @return Number of devices re-rated
+     */
+    int setTypeWatts(const std::string& type, double w, SimTime now) {
+        int t = typeIndex(type, w);
+        typeWatts[t] = w;
+        int changed = 0;
+        for (size_t id = 0; id < tracked.size(); ++id) {
+            if (!tracked[id] || typeOf[id] != t || customWatts[id]) continue;
+            rate(static_cast<int>(id), w, now);
+            changed++;
+        }
+        return changed;
+    }
+
+    /**
+     * @brief Returns whether a type name has a wattage.
+     */
+    bool hasType(const std::string& type) const {
+        for (const auto& name : typeNames) {
+            if (name == type) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns a device's energy up to `now` in watt-seconds (0 if unregistered).
+     */
+    double deviceEnergy(int id, SimTime now) const {
+        if (needsDevice(id)) return 0.0;
+        double open = onSince[id] >= 0 ? watts[id] * SimClock::toSeconds(now - onSince[id]) : 0.0;
+        return energy[id] + open;
+    }
+
+    /**
+     * @brief Returns a device's current power draw in watts.
+     */
+    double devicePower(int id) const {
+        return needsDevice(id) || onSince[id] < 0 ? 0.0 : watts[id];
+    }
+
+    /**
+     * @brief Returns the running sums of a zone's subtree.
+     */
+    const Totals& zone(int z) const {
+        static const Totals none;
+        return z >= 0 && z < static_cast<int>(zoneTotals.size()) ? zoneTotals[z] : none;
+    }
+
+    /**
+     * @brief Returns the running sums of the whole home.
+     */
+    const Totals& homeTotals() const { return home; }
+
+    /**
+     * @brief Moves the clock base from `from` to `to` (e.g., when the simulation is reset).
+     *
+     * Open intervals are closed at `from` and reopened at `to`; energy used so far is kept.
+     */
+    void rebase(SimTime from, SimTime to) {
+        auto shift = [&](Totals& t) {
+            t.closed = t.energyAt(from);
+            t.weighted = t.power * SimClock::toSeconds(to);
+        };
+        shift(home);
+        for (Totals& t : zoneTotals) shift(t);
+        for (size_t id = 0; id < onSince.size(); ++id) {
+            if (onSince[id] < 0) continue;
+            energy[id] += watts[id] * SimClock::toSeconds(from - onSince[id]);
+            onSince[id] = to;
+        }
+    }
+
+    /**
+     * @brief Prints one total as energy and current power.
+     * @param label What the total covers (e.g., "home", a zone or device name)
+     * @param wattSeconds Energy in watt-seconds
+     * @param power Current power in watts
+     */
+    static void printTotal(const std::string& label, double wattSeconds, double power) {
+        std::cout << "[Energy] " << label << ": " << std::fixed << std::setprecision(3)
+                  << wattSeconds / 3.6e6 << " kWh, drawing " << std::setprecision(1) << power
+                  << " W now\n" << std::defaultfloat << std::setprecision(6);
+    }
+
+    /**
+     * @brief Prints every registered device's wattage and energy, then the home total.
+     * Called by the "energy-report" command in the CLI.
+     */
+    void printReport(SimTime now) const {
+        std::cout << "\n===== Energy Report (t=" << SimClock::format(now) << ") =====\n";
+        std::cout << std::fixed;
+        for (size_t id = 0; id < tracked.size(); ++id) {
+            if (!tracked[id]) continue;
+            int i = static_cast<int>(id);
+            std::cout << "- " << labels[id] << ": " << std::setprecision(1) << watts[id] << " W"
+                      << (customWatts[id] ? " (custom)" : "") << ", " << std::setprecision(2)
+                      << deviceEnergy(i, now) / 3600.0 << " Wh" << (onSince[id] >= 0 ? " [ON]" : "") << "\n";
+        }
+        std::cout << std::defaultfloat << std::setprecision(6);
+        printTotal("home", home.energyAt(now), home.power);
+        std::cout << "====================================\n";
+    }
+
+private:
+    /**
+     * @brief Returns the index of a type, adding it with `defaultWatts` if new.
+     */
+    int typeIndex(const std::string& type, double defaultWatts) {
+        for (size_t t = 0; t < typeNames.size(); ++t) {
+            if (typeNames[t] == type) return static_cast<int>(t);
+        }
+        typeNames.push_back(type);
+        typeWatts.push_back(defaultWatts);
+        return static_cast<int>(typeNames.size() - 1);
+    }
+
+    /**
+     * @brief Applies `f` to the home totals and to the totals of the device's zone chain.
+     */
+    template <typename F>
+    void forTotals(int id, F f) {
+        f(home);
+        for (int z = zoneOf[id]; z >= 0; z = zoneParent[z]) f(zoneTotals[z]);
+    }
+
+    /**
+     * @brief Starts an ON interval at `now`.
+     */
+    void open(int id, SimTime now) {
+        double w = watts[id], weight = w * SimClock::toSeconds(now);
+        onSince[id] = now;
+        forTotals(id, [&](Totals& t) {
+            t.power += w;
+            t.weighted += weight;
+        });
+    }
+
+    /**
+     * @brief Ends the open ON interval at `now` and books its energy.
+     */
+    void close(int id, SimTime now) {
+        double w = watts[id];
+        double used = w * SimClock::toSeconds(now - onSince[id]);
+        double weight = w * SimClock::toSeconds(onSince[id]);
+        energy[id] += used;
+        onSince[id] = -1;
+        forTotals(id, [&](Totals& t) {
+            t.closed += used;
+            t.power -= w;
+            t.weighted -= weight;
+        });
+    }
+
+    /**
+     * @brief Changes a device's wattage, splitting an open interval at `now`.
+     */
+    void rate(int id, double w, SimTime now) {
+        bool on = onSince[id] >= 0;
+        if (on) close(id, now);
+        watts[id] = w;
+        if (on) open(id, now);
+    }
+};
+
+#endif // ENERGY_METER_H
@@ -0,0 +1,126 @@
+/**
+ * @file FramePool.h
+ * @brief Size-class pool allocator for coroutine frames.
+ *
+ * The `FramePool` class hands out the memory for device behavior coroutines
+ * (see `BehaviorRuntime`). Frames are rounded up to a 64-byte size class and
+ * carved out of large chunks; freed frames go onto the free list of their class
+ * and are reused by the next frame of that size. With millions of behaviors
+ * started and finished, this replaces a general-purpose malloc/free pair per
+ * behavior with a pointer pop and push, and keeps frames of one kind densely packed.
+ *
+ * Frames larger than the biggest class fall back to operator new. The pool is
+ * not thread-safe; like the rest of the simulation it is used from one thread.
+ *
+ * Responsibilities:
+ * - Allocate and free frames in O(1) through per-class free lists
+ * - Grow in chunks and never return chunk memory to the system
+ * - Count live frames and pool memory for the `behaviors` command
+ */
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+class FramePool {
+public:
+    static constexpr size_t GRANULE = 64;          ///< Size classes are multiples of this
+    static constexpr size_t CLASS_COUNT = 16;      ///< Largest pooled frame: 1 KiB
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    /**
+     * @brief Allocation counters.
+     */
+    struct Stats {
+        uint64_t allocations = 0;  ///< Frames handed out
+        uint64_t reused = 0;       ///< Of those, served from a free list
+        uint64_t oversized = 0;    ///< Of those, too large for the pool
+        uint64_t live = 0;         ///< Frames currently allocated
+        uint64_t chunkBytes = 0;   ///< Memory reserved from the system
+    };
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* freeLists[CLASS_COUNT] = {};
+    char* chunkCursor[CLASS_COUNT] = {};           ///< Next uncarved byte of each class's chunk
+    char* chunkEnd[CLASS_COUNT] = {};
+    std::vector<std::unique_ptr<char[]>> chunks;
+    Stats stats;
+
+    FramePool() = default;
+
+public:
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    /**
+     * @brief Returns the process-wide pool.
+     */
+    static FramePool& instance() {
+        static FramePool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Allocates a frame of at least `size` bytes.
+     */
+    void* allocate(size_t size) {
+        stats.allocations++;
+        stats.live++;
+        size_t c = classOf(size);
+        if (c >= CLASS_COUNT) {
+            stats.oversized++;
+            return ::operator new(size);
+        }
+        if (FreeBlock* b = freeLists[c]) {
+            freeLists[c] = b->next;
+            stats.reused++;
+            return b;
+        }
+        size_t blockSize = (c + 1) * GRANULE;
+        if (chunkCursor[c] == chunkEnd[c]) {
+            chunks.emplace_back(new char[CHUNK_BYTES]);
+            chunkCursor[c] = chunks.back().get();
+            chunkEnd[c] = chunkCursor[c] + CHUNK_BYTES / blockSize * blockSize;
+            stats.chunkBytes += CHUNK_BYTES;
+        }
+        void* p = chunkCursor[c];
+        chunkCursor[c] += blockSize;
+        return p;
+    }
+
+    /**
+     * @brief Returns a frame; `size` must be the size it was allocated with.
+     */
+    void deallocate(void* p, size_t size) {
+        stats.live--;
+        size_t c = classOf(size);
+        if (c >= CLASS_COUNT) {
+            ::operator delete(p);
+            return;
+        }
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = freeLists[c];
+        freeLists[c] = b;
+    }
+
+    /**
+     * @brief Returns the allocation counters.
+     */
+    const Stats& getStats() const { return stats; }
+
+private:
+    static size_t classOf(size_t size) {
+        return size == 0 ? 0 : (size - 1) / GRANULE;
+    }
+};
+
+#endif // FRAME_POOL_H
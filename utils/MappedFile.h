@@ -0,0 +1,97 @@
+/**
+ * @file MappedFile.h
+ * @brief Read-only, memory-mapped view of a whole file.
+ *
+ * The `MappedFile` class maps a file into memory with mmap where available and
+ * falls back to reading it into one buffer elsewhere (e.g., on Windows). Bulk
+ * loaders (trace ingestion, schedule import) parse directly from the mapped bytes.
+ *
+ * Only regular files are accepted; an empty file opens as a view of zero bytes.
+ *
+ * Responsibilities:
+ * - Map or read an entire file in one step
+ * - Release the mapping when the view goes out of scope
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+    const char* bytes = nullptr;   ///< Start of the file contents
+    size_t length = 0;             ///< File size in bytes
+    bool opened = false;           ///< Whether the whole file was mapped or read
+    bool mapped = false;           ///< Whether `bytes` is an mmap region
+    std::vector<char> fallback;    ///< Buffer used when mmap is unavailable
+
+public:
+    /**
+     * @brief Maps the given file.
+     * @param path Path of the file to open
+     */
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return;
+        }
+        if (st.st_size == 0) {
+            ::close(fd);
+            opened = true;
+            return;
+        }
+        void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ::madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(p);
+            length = static_cast<size_t>(st.st_size);
+            mapped = true;
+        }
+        ::close(fd);
+        if (mapped) {
+            opened = true;
+            return;
+        }
+#endif
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) return;
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return;
+        std::streamoff size = in.tellg();
+        if (size < 0) return;
+        fallback.resize(static_cast<size_t>(size));
+        in.seekg(0);
+        if (!in.read(fallback.data(), static_cast<std::streamsize>(fallback.size()))) return;
+        bytes = fallback.data();
+        length = fallback.size();
+        opened = true;
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapped) ::munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+#endif // MAPPED_FILE_H
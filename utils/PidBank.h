@@ -0,0 +1,278 @@
+/**
+ * @file PidBank.h
+ * @brief Structure-of-arrays PID controllers updated in one vectorized pass.
+ *
+ * The `PidBank` class holds the controller state of every thermostat (setpoint,
+ * gains, integral, last measurement, output and output limit) in parallel
+ * padded, 32-byte aligned arrays indexed by controller slot. `update()` reads
+ * each enabled controller's measurement from a shared array of room
+ * temperatures through its room index and steps all controllers at once with
+ * an AVX2 kernel (8 lanes, gathered measurements) or the portable scalar
+ * fallback, selected at runtime like the other kernels. No per-device virtual
+ * call is involved.
+ *
+ * Per controller and step of `dt` seconds, with error e = setpoint - measured:
+ *
+ *     u = kp * e + ki * integral + kd * -(measured - lastMeasured) / dt
+ *
+ * clamped to [-limit, limit] (positive heats, negative cools). The derivative
+ * acts on the measurement so setpoint changes do not kick the output, and the
+ * integral only accumulates while that does not push the output past its limit
+ * (anti-windup). Disabled controllers output 0 and keep their state.
+ *
+ * Responsibilities:
+ * - Allocate and reuse controller slots
+ * - Keep controller state in aligned arrays
+ * - Step all controllers with the best available kernel
+ */
+
+#ifndef PID_BANK_H
+#define PID_BANK_H
+
+#include <cstdint>
+#include <vector>
+#include "AlignedAllocator.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SMARTHOME_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace pid_kernels {
+
+/**
+ * @brief Controller arrays of one update; all have `count` entries, a multiple of 8.
+ */
+struct Lanes {
+    const float* setpoint;
+    const float* kp;
+    const float* ki;
+    const float* kd;
+    const float* limit;       ///< Output bound (e.g., the thermostat mode's power)
+    const float* enabled;     ///< 1 = running, 0 = output 0 and state frozen
+    const int32_t* room;      ///< Index of the measurement in the temperature array
+    float* integral;
+    float* lastMeasured;
+    float* output;
+    size_t count;
+};
+
+using Kernel = void (*)(const Lanes& lanes, const float* temps, float dt);
+
+/**
+ * @brief Portable kernel: one controller at a time.
+ */
+inline void updateScalar(const Lanes& l, const float* temps, float dt) {
+    for (size_t i = 0; i < l.count; ++i) {
+        if (l.enabled[i] == 0.0f) {
+            l.output[i] = 0.0f;
+            continue;
+        }
+        float m = temps[l.room[i]];
+        float e = l.setpoint[i] - m;
+        float d = -(m - l.lastMeasured[i]) / dt;
+        float base = l.kp[i] * e + l.kd[i] * d;
+        float integral = l.integral[i] + e * dt;
+        float u = base + l.ki[i] * integral;
+        if (u > l.limit[i] || u < -l.limit[i]) {
+            integral = l.integral[i];  // Saturated: do not wind up
+            u = base + l.ki[i] * integral;
+        }
+        l.integral[i] = integral;
+        l.lastMeasured[i] = m;
+        l.output[i] = u > l.limit[i] ? l.limit[i] : u < -l.limit[i] ? -l.limit[i] : u;
+    }
+}
+
+#ifdef SMARTHOME_X86_SIMD
+/**
+ * @brief AVX2 kernel: 8 controllers per instruction, measurements gathered by room index.
+ */
+__attribute__((target("avx2")))
+inline void updateAvx2(const Lanes& l, const float* temps, float dt) {
+    const __m256 h = _mm256_set1_ps(dt), invH = _mm256_set1_ps(1.0f / dt), zero = _mm256_setzero_ps();
+    for (size_t i = 0; i < l.count; i += 8) {
+        __m256 on = _mm256_cmp_ps(_mm256_load_ps(l.enabled + i), zero, _CMP_NEQ_OQ);
+        __m256 last = _mm256_load_ps(l.lastMeasured + i);
+        __m256i room = _mm256_load_si256(reinterpret_cast<const __m256i*>(l.room + i));
+        __m256 m = _mm256_mask_i32gather_ps(last, temps, room, on, 4);
+
+        __m256 e = _mm256_sub_ps(_mm256_load_ps(l.setpoint + i), m);
+        __m256 d = _mm256_mul_ps(_mm256_sub_ps(last, m), invH);
+        __m256 base = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(l.kp + i), e),
+                                    _mm256_mul_ps(_mm256_load_ps(l.kd + i), d));
+        __m256 ki = _mm256_load_ps(l.ki + i), limit = _mm256_load_ps(l.limit + i);
+        __m256 oldIntegral = _mm256_load_ps(l.integral + i);
+        __m256 integral = _mm256_add_ps(oldIntegral, _mm256_mul_ps(e, h));
+        __m256 u = _mm256_add_ps(base, _mm256_mul_ps(ki, integral));
+
+        // Saturated: do not wind up
+        __m256 negLimit = _mm256_sub_ps(zero, limit);
+        __m256 saturated = _mm256_or_ps(_mm256_cmp_ps(u, limit, _CMP_GT_OQ), _mm256_cmp_ps(u, negLimit, _CMP_LT_OQ));
+        integral = _mm256_blendv_ps(integral, oldIntegral, saturated);
+        u = _mm256_add_ps(base, _mm256_mul_ps(ki, integral));
+        u = _mm256_max_ps(_mm256_min_ps(u, limit), negLimit);
+
+        _mm256_store_ps(l.integral + i, _mm256_blendv_ps(oldIntegral, integral, on));
+        _mm256_store_ps(l.lastMeasured + i, m);
+        _mm256_store_ps(l.output + i, _mm256_and_ps(u, on));
+    }
+}
+#endif
+
+/**
+ * @brief Picks the widest kernel the running CPU supports.
+ * @param name Receives the kernel's name for reporting
+ */
+inline Kernel select(const char*& name) {
+#ifdef SMARTHOME_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) { name = "AVX2"; return updateAvx2; }
+#endif
+    name = "scalar";
+    return updateScalar;
+}
+
+} // namespace pid_kernels
+
+class PidBank {
+public:
+    static constexpr float DEFAULT_KP = 0.5f;    ///< Output per degree of error
+    static constexpr float DEFAULT_KI = 0.001f;  ///< Output per degree-second of accumulated error
+    static constexpr float DEFAULT_KD = 10.0f;   ///< Output per degree-per-second of change
+
+private:
+    AlignedVector<float> setpoint, kp, ki, kd, limit, enabled, integral, lastMeasured, output;
+    AlignedVector<int32_t> room;
+    std::vector<int> freeSlots;                  ///< Released slots to reuse
+    size_t used = 0;                             ///< Slots handed out (including released ones)
+    pid_kernels::Kernel kernel;                  ///< Selected update kernel
+    const char* kernelName = "scalar";           ///< Name of the selected kernel
+    long long updates = 0;                       ///< Batch passes run
+
+public:
+    /**
+     * @brief Constructs an empty bank and selects the update kernel.
+     */
+    PidBank() { kernel = pid_kernels::select(kernelName); }
+
+    /**
+     * @brief Allocates a disabled controller with the default gains.
+     * @param target Initial setpoint
+     * @return The controller's slot
+     */
+    int add(float target) {
+        int slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<int>(used++);
+            if (slot % 8 == 0) grow(slot + 8);
+        }
+        setpoint[slot] = target;
+        kp[slot] = DEFAULT_KP;
+        ki[slot] = DEFAULT_KI;
+        kd[slot] = DEFAULT_KD;
+        limit[slot] = 1.0f;
+        enabled[slot] = 0.0f;
+        integral[slot] = 0.0f;
+        lastMeasured[slot] = target;
+        output[slot] = 0.0f;
+        room[slot] = 0;
+        return slot;
+    }
+
+    /**
+     * @brief Disables a controller and returns its slot for reuse.
+     */
+    void release(int slot) {
+        enabled[slot] = 0.0f;
+        output[slot] = 0.0f;
+        freeSlots.push_back(slot);
+    }
+
+    void setSetpoint(int slot, float t) { setpoint[slot] = t; }
+    void setLimit(int slot, float l) { limit[slot] = l; }
+
+    /**
+     * @brief Sets a controller's gains and clears its integral.
+     */
+    void setGains(int slot, float p, float i, float d) {
+        kp[slot] = p;
+        ki[slot] = i;
+        kd[slot] = d;
+        integral[slot] = 0.0f;
+    }
+
+    /**
+     * @brief Connects a controller to a measurement and enables it.
+     * @param slot Controller slot
+     * @param index Index of its measurement in the array passed to update()
+     * @param current Current measurement (avoids a derivative kick on the first step)
+     */
+    void connect(int slot, int index, float current) {
+        room[slot] = index;
+        lastMeasured[slot] = current;
+        enabled[slot] = 1.0f;
+    }
+
+    /**
+     * @brief Disconnects a controller from its measurement, disabling it.
+     */
+    void disconnect(int slot) {
+        enabled[slot] = 0.0f;
+        output[slot] = 0.0f;
+        integral[slot] = 0.0f;
+        room[slot] = 0;
+    }
+
+    /**
+     * @brief Pauses or resumes a connected controller (e.g., while its device is OFF).
+     *
+     * On resume the derivative term restarts from the current measurement, as
+     * in connect(), so a change while paused causes no derivative kick.
+     *
+     * @param slot Controller slot
+     * @param on Whether the controller runs
+     * @param current Current value of its measurement
+     */
+    void setEnabled(int slot, bool on, float current) {
+        if (on && enabled[slot] == 0.0f) lastMeasured[slot] = current;
+        enabled[slot] = on ? 1.0f : 0.0f;
+    }
+
+    float getSetpoint(int slot) const { return setpoint[slot]; }
+    float getOutput(int slot) const { return output[slot]; }
+    float getIntegral(int slot) const { return integral[slot]; }
+    float getKp(int slot) const { return kp[slot]; }
+    float getKi(int slot) const { return ki[slot]; }
+    float getKd(int slot) const { return kd[slot]; }
+    size_t size() const { return used - freeSlots.size(); }
+    const char* getKernelName() const { return kernelName; }
+    long long getUpdates() const { return updates; }
+
+    /**
+     * @brief Steps every controller once.
+     * @param temps Measurements, indexed by the controllers' connected index
+     * @param dt Step length in seconds
+     */
+    void update(const float* temps, float dt) {
+        if (used == 0) return;
+        pid_kernels::Lanes lanes{setpoint.data(), kp.data(), ki.data(), kd.data(), limit.data(),
+                                 enabled.data(), room.data(), integral.data(), lastMeasured.data(),
+                                 output.data(), setpoint.size()};
+        kernel(lanes, temps, dt);
+        updates++;
+    }
+
+private:
+    void grow(size_t padded) {
+        for (auto* v : {&setpoint, &kp, &ki, &kd, &limit, &enabled, &integral, &lastMeasured, &output}) {
+            v->resize(padded, 0.0f);
+        }
+        room.resize(padded, 0);
+    }
+};
+
+#endif // PID_BANK_H
@@ -0,0 +1,233 @@
+/**
+ * @file ScheduleImporter.h
+ * @brief Bulk import of scheduled tasks from a file into the Scheduler.
+ *
+ * The `ScheduleImporter` class loads large schedule files (e.g., ~1M tasks pushed
+ * at deploy time) without going through the interactive `schedule` prompts. The
+ * file is memory-mapped and split into chunks at line boundaries. The chunks are
+ * parsed in parallel, one thread each; threads resolve device names through a
+ * read-only name table built once up front, create the strategies and compute
+ * each task's first due time. The results are then inserted into the Scheduler
+ * in one step with a single heap build.
+ *
+ * File format (one task per line; blank lines and `#` comments are skipped):
+ *
+ *     <device name>,<on|off>,at,<time>            one-time at an absolute time
+ *     <device name>,<on|off>,after,<duration>     delayed, relative to the import time
+ *     <device name>,<on|off>,every,<duration>     periodic
+ *     <device name>,<on|off>,cron,<expression>
+ *
+ * Times and durations are seconds, optionally fractional or with a unit
+ * (`0.25`, `250ms`, `10m`; see SimClock::parseDuration()).
+ *
+ * Responsibilities:
+ * - Split the mapped file into chunks and parse them concurrently
+ * - Resolve device names in bulk
+ * - Hand all tasks to Scheduler::addTasks() in one batch
+ * - Report tasks/sec
+ */
+
+#ifndef SCHEDULE_IMPORTER_H
+#define SCHEDULE_IMPORTER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "MappedFile.h"
+#include "SimClock.h"
+#include "../controllers/DeviceController.h"
+#include "../controllers/Scheduler.h"
+#include "../models/strategies/scheduling/CronSchedule.h"
+#include "../models/strategies/scheduling/DelayedSchedule.h"
+#include "../models/strategies/scheduling/OneTimeSchedule.h"
+#include "../models/strategies/scheduling/PeriodicSchedule.h"
+
+class ScheduleImporter {
+public:
+    /**
+     * @brief Outcome of one import.
+     */
+    struct Result {
+        bool ok = false;            ///< Whether the file could be read
+        long long tasks = 0;        ///< Tasks inserted
+        long long skipped = 0;      ///< Malformed lines, unknown devices, tasks that never fire or were rejected
+        long long conflicts = 0;    ///< Same-instant pairs detected (conflicting or redundant)
+        int threads = 0;            ///< Parser threads used
+        double parseSeconds = 0.0;  ///< Wall-clock time of the parallel parse
+        double buildSeconds = 0.0;  ///< Wall-clock time of the bulk insertion
+    };
+
+private:
+    /**
+     * @brief Output of one parser thread.
+     */
+    struct Chunk {
+        std::string_view text;
+        std::vector<Scheduler::NewTask> tasks;
+        long long skipped = 0;
+    };
+
+    DeviceController& controller;
+    Scheduler& scheduler;
+
+public:
+    /**
+     * @brief Constructs an importer for the given devices and scheduler.
+     */
+    ScheduleImporter(DeviceController& devices, Scheduler& target) : controller(devices), scheduler(target) {}
+
+    /**
+     * @brief Imports a schedule file.
+     * @param path Schedule file
+     * @param threads Parser threads (0 = one per hardware thread)
+     * @return Counters and timings of the run
+     */
+    Result import(const std::string& path, unsigned threads = 0) {
+        Result result;
+        MappedFile file(path);
+        if (!file.isOpen()) return result;
+        result.ok = true;
+
+        auto begin = std::chrono::steady_clock::now();
+        const std::vector<SmartDevice*>& devices = controller.getAllDevices();
+        std::vector<std::string> keys;  // getName() returns by value; the name table views these
+        keys.reserve(devices.size());
+        for (SmartDevice* d : devices) keys.push_back(d->getName());
+        std::unordered_map<std::string_view, SmartDevice*> names;
+        names.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) names.emplace(keys[i], devices[i]);
+
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<Chunk> chunks = split(std::string_view(file.data(), file.size()), threads);
+        result.threads = static_cast<int>(chunks.size());
+        SimTime now = SimClock::now();
+
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            workers.emplace_back([&, i] { parseChunk(chunks[i], names, now); });
+        }
+        if (!chunks.empty()) parseChunk(chunks[0], names, now);
+        for (auto& w : workers) w.join();
+
+        auto parsed = std::chrono::steady_clock::now();
+        std::vector<Scheduler::NewTask> all;
+        size_t total = 0;
+        for (const auto& c : chunks) total += c.tasks.size();
+        all.reserve(total);
+        for (auto& c : chunks) {
+            all.insert(all.end(), c.tasks.begin(), c.tasks.end());
+            result.skipped += c.skipped;
+        }
+        const Scheduler::ConflictStats& stats = scheduler.getConflictStats();
+        uint64_t before = stats.conflicts + stats.redundant;
+        result.tasks = static_cast<long long>(scheduler.addTasks(all));
+        result.conflicts = static_cast<long long>(stats.conflicts + stats.redundant - before);
+        result.skipped += static_cast<long long>(all.size()) - result.tasks;
+
+        auto end = std::chrono::steady_clock::now();
+        result.parseSeconds = std::chrono::duration<double>(parsed - begin).count();
+        result.buildSeconds = std::chrono::duration<double>(end - parsed).count();
+        return result;
+    }
+
+    /**
+     * @brief Prints a run's throughput report.
+     */
+    static void printResult(const std::string& path, const Result& r) {
+        if (!r.ok) {
+            std::cout << "[Import] Error: cannot read \"" << path << "\".\n";
+            return;
+        }
+        double seconds = r.parseSeconds + r.buildSeconds;
+        std::cout << "[Import] " << r.tasks << " tasks from \"" << path << "\" in " << seconds * 1000.0
+                  << " ms (parse " << r.parseSeconds * 1000.0 << " ms on " << r.threads
+                  << " threads, build " << r.buildSeconds * 1000.0 << " ms)";
+        if (seconds > 0.0) std::cout << ", " << static_cast<long long>(r.tasks / seconds) << " tasks/s";
+        if (r.skipped > 0) std::cout << ", " << r.skipped << " lines skipped";
+        if (r.conflicts > 0) std::cout << ", " << r.conflicts << " conflicts (see `conflicts`)";
+        std::cout << "\n";
+    }
+
+private:
+    /**
+     * @brief Splits the text into up to `count` chunks that end on line boundaries.
+     */
+    static std::vector<Chunk> split(std::string_view text, unsigned count) {
+        std::vector<Chunk> chunks;
+        size_t pos = 0;
+        for (unsigned i = 0; i < count && pos < text.size(); ++i) {
+            size_t end = i + 1 == count ? text.size() : std::max(pos, text.size() * (i + 1) / count);
+            if (end < text.size()) {
+                const void* nl = std::memchr(text.data() + end, '\n', text.size() - end);
+                end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - text.data()) + 1 : text.size();
+            }
+            chunks.push_back(Chunk{text.substr(pos, end - pos), {}, 0});
+            pos = end;
+        }
+        return chunks;
+    }
+
+    /**
+     * @brief Parses one chunk; runs on a worker thread and only reads shared state.
+     */
+    static void parseChunk(Chunk& chunk, const std::unordered_map<std::string_view, SmartDevice*>& names, SimTime now) {
+        std::string_view text = chunk.text;
+        chunk.tasks.reserve(text.size() / 24);
+        std::string error;
+        while (!text.empty()) {
+            size_t eol = text.find('\n');
+            std::string_view line = text.substr(0, eol);
+            text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty() || line.front() == '#') continue;
+
+            Scheduler::NewTask task{};
+            if (parseLine(line, names, now, task, error)) chunk.tasks.push_back(task);
+            else chunk.skipped++;
+        }
+    }
+
+    /**
+     * @brief Parses "<device>,<on|off>,<kind>,<argument>" into a task.
+     */
+    static bool parseLine(std::string_view line, const std::unordered_map<std::string_view, SmartDevice*>& names,
+                          SimTime now, Scheduler::NewTask& task, std::string& error) {
+        size_t c1 = line.find(',');
+        size_t c2 = c1 == std::string_view::npos ? c1 : line.find(',', c1 + 1);
+        size_t c3 = c2 == std::string_view::npos ? c2 : line.find(',', c2 + 1);
+        if (c3 == std::string_view::npos) return false;
+
+        auto it = names.find(line.substr(0, c1));
+        if (it == names.end()) return false;
+        std::string_view state = line.substr(c1 + 1, c2 - c1 - 1);
+        if (state != "on" && state != "off") return false;
+        std::string_view kind = line.substr(c2 + 1, c3 - c2 - 1);
+        std::string_view arg = line.substr(c3 + 1);
+
+        SchedulingStrategy* strategy = nullptr;
+        if (kind == "cron") {
+            strategy = CronSchedule::compile(std::string(arg), error);
+        } else {
+            SimTime value;
+            if (!SimClock::parseDuration(arg, value)) return false;
+            if (kind == "at") strategy = new OneTimeSchedule(value);
+            else if (kind == "after") strategy = new DelayedSchedule(now + value);
+            else if (kind == "every" && value > 0) strategy = new PeriodicSchedule(value);
+        }
+        if (!strategy) return false;
+
+        task.device = it->second;
+        task.turnOn = state == "on";
+        task.strategy = strategy;
+        task.due = strategy->nextFireTime(now);
+        return true;
+    }
+};
+
+#endif // SCHEDULE_IMPORTER_H
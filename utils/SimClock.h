@@ -0,0 +1,134 @@
+/**
+ * @file SimClock.h
+ * @brief Shared simulated clock for SmartHomeSim.
+ *
+ * The `SimClock` class holds the current simulated time so that components which
+ * are not handed the time explicitly (observers, persistence) can timestamp the
+ * events they record. The CLI advances it on every tick and resets it on reset.
+ *
+ * Simulated time is a `SimTime`: a signed 64-bit count of microseconds. That
+ * resolves sub-second events (a 10 Hz motion sensor) and does not overflow for
+ * about 292,000 simulated years. Durations use the same type; the constants
+ * below convert from human units.
+ *
+ * Responsibilities:
+ * - Store the current simulated time
+ * - Provide global read access to the time for observers
+ * - Convert between SimTime and seconds, and parse and format durations
+ */
+
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using SimTime = int64_t;  ///< Simulated time or duration in microseconds
+
+class SimClock {
+    static inline SimTime currentTime = 0;  ///< Current simulated time
+
+public:
+    static constexpr SimTime MICROSECOND = 1;
+    static constexpr SimTime MILLISECOND = 1000;
+    static constexpr SimTime SECOND = 1000000;
+    static constexpr SimTime MINUTE = 60 * SECOND;
+    static constexpr SimTime HOUR = 60 * MINUTE;
+    static constexpr SimTime DAY = 24 * HOUR;
+
+    /**
+     * @brief Returns the current simulated time.
+     * @return Simulated time in microseconds
+     */
+    static SimTime now() { return currentTime; }
+
+    /**
+     * @brief Sets the current simulated time.
+     * @param time New simulated time in microseconds
+     */
+    static void set(SimTime time) { currentTime = time; }
+
+    /**
+     * @brief Returns whole seconds of a time (rounded toward negative infinity).
+     */
+    static int64_t wholeSeconds(SimTime t) {
+        return t >= 0 ? t / SECOND : -((-t + SECOND - 1) / SECOND);
+    }
+
+    /**
+     * @brief Converts a time to fractional seconds.
+     */
+    static double toSeconds(SimTime t) { return static_cast<double>(t) / SECOND; }
+
+    /**
+     * @brief Converts whole seconds to a time.
+     */
+    static constexpr SimTime fromSeconds(int64_t seconds) { return seconds * SECOND; }
+
+    /**
+     * @brief Parses a duration such as "5", "0.1", "1.5s", "250ms", "40us", "2m", "1h" or "3d".
+     *
+     * A plain number is in seconds. Digits beyond microsecond precision are ignored.
+     *
+     * @param text Text to parse (no surrounding spaces)
+     * @param out Receives the duration
+     * @return false if the text is not a duration
+     */
+    static bool parseDuration(std::string_view text, SimTime& out) {
+        size_t i = 0;
+        bool negative = !text.empty() && text[0] == '-';
+        if (negative) i++;
+        int64_t whole = 0, fraction = 0, scale = 1;
+        size_t digits = 0;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i, ++digits) {
+            if (whole > (INT64_MAX - 9) / 10) return false;
+            whole = whole * 10 + (text[i] - '0');
+        }
+        if (i < text.size() && text[i] == '.') {
+            for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i, ++digits) {
+                if (scale < SECOND) {
+                    fraction = fraction * 10 + (text[i] - '0');
+                    scale *= 10;
+                }
+            }
+        }
+        if (digits == 0) return false;
+
+        std::string_view unit = text.substr(i);
+        SimTime unitSize;
+        if (unit.empty() || unit == "s") unitSize = SECOND;
+        else if (unit == "ms") unitSize = MILLISECOND;
+        else if (unit == "us") unitSize = MICROSECOND;
+        else if (unit == "m") unitSize = MINUTE;
+        else if (unit == "h") unitSize = HOUR;
+        else if (unit == "d") unitSize = DAY;
+        else return false;
+
+        // fraction < scale <= SECOND, so the fractional part (< 1 unit) cannot overflow
+        SimTime fractionPart = fraction * unitSize / scale;
+        if (whole > (INT64_MAX - fractionPart) / unitSize) return false;
+        out = whole * unitSize + fractionPart;
+        if (negative) out = -out;
+        return true;
+    }
+
+    /**
+     * @brief Formats a time in seconds, with as many decimals as it needs ("12s", "0.1s", "3.000250s").
+     */
+    static std::string format(SimTime t) {
+        std::string s = t < 0 ? "-" : "";
+        uint64_t magnitude = t < 0 ? 0 - static_cast<uint64_t>(t) : static_cast<uint64_t>(t);
+        s += std::to_string(magnitude / SECOND);
+        uint64_t micros = magnitude % SECOND;
+        if (micros != 0) {
+            std::string frac = std::to_string(micros);
+            frac.insert(0, 6 - frac.size(), '0');
+            while (frac.back() == '0') frac.pop_back();
+            s += "." + frac;
+        }
+        return s + "s";
+    }
+};
+
+#endif // SIM_CLOCK_H
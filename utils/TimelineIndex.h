@@ -0,0 +1,116 @@
+/**
+ * @file TimelineIndex.h
+ * @brief Flat hash table from (device, instant) keys to the head of a chain of tasks.
+ *
+ * The `TimelineIndex` class backs the Scheduler's conflict detection. Keys are a
+ * device handle and a simulated instant (SimTime); values are indices into the
+ * Scheduler's entry pool. The table uses open addressing with linear probing
+ * in one contiguous array, so a lookup is usually a single cache miss and
+ * inserting allocates nothing until the table grows.
+ *
+ * Responsibilities:
+ * - Find or insert the chain head of a key in O(1) expected time
+ * - Drop keys in bulk (past instants) by rebuilding the table
+ */
+
+#ifndef TIMELINE_INDEX_H
+#define TIMELINE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SimClock.h"
+
+class TimelineIndex {
+public:
+    static constexpr uint32_t NO_ENTRY = ~uint32_t(0);  ///< Value of a key with an empty chain
+
+private:
+    static constexpr int EMPTY = -1;  ///< Device of an unused cell
+
+    struct Cell {
+        SimTime instant;
+        int device;
+        uint32_t head;
+    };
+
+    std::vector<Cell> cells;  ///< Power-of-two sized, at most half full
+    size_t used = 0;
+
+public:
+    /**
+     * @brief Returns the number of keys.
+     */
+    size_t size() const { return used; }
+
+    /**
+     * @brief Makes room for `count` keys without further growth.
+     */
+    void reserve(size_t count) {
+        size_t capacity = 16;
+        while (capacity < count * 2) capacity *= 2;
+        if (capacity > cells.size()) rehash(capacity);
+    }
+
+    /**
+     * @brief Returns the chain head of a key, inserting NO_ENTRY if the key is new.
+     *
+     * The reference stays valid until the next call that inserts or removes keys.
+     */
+    uint32_t& at(int device, SimTime instant) {
+        if ((used + 1) * 2 > cells.size()) rehash(cells.empty() ? 16 : cells.size() * 2);
+        size_t mask = cells.size() - 1;
+        for (size_t i = hash(device, instant) & mask;; i = (i + 1) & mask) {
+            if (cells[i].instant == instant && cells[i].device == device) return cells[i].head;
+            if (cells[i].device == EMPTY) {
+                cells[i] = Cell{instant, device, NO_ENTRY};
+                used++;
+                return cells[i].head;
+            }
+        }
+    }
+
+    /**
+     * @brief Removes every key for which pred(instant) is true, calling onRemove(head) for each.
+     */
+    template <typename Pred, typename OnRemove>
+    void removeIf(Pred pred, OnRemove onRemove) {
+        std::vector<Cell> old;
+        old.swap(cells);
+        cells.assign(old.size(), Cell{0, EMPTY, NO_ENTRY});
+        used = 0;
+        size_t mask = cells.size() - 1;
+        for (const Cell& c : old) {
+            if (c.device == EMPTY) continue;
+            if (pred(c.instant)) {
+                onRemove(c.head);
+                continue;
+            }
+            size_t i = hash(c.device, c.instant) & mask;
+            while (cells[i].device != EMPTY) i = (i + 1) & mask;
+            cells[i] = c;
+            used++;
+        }
+    }
+
+private:
+    static size_t hash(int device, SimTime instant) {
+        uint64_t k = (static_cast<uint64_t>(instant) ^ (static_cast<uint64_t>(device) << 40)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(k ^ (k >> 32));  // Fold the high bits into the low bits used for the slot
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Cell> old;
+        old.swap(cells);
+        cells.assign(capacity, Cell{0, EMPTY, NO_ENTRY});
+        size_t mask = capacity - 1;
+        for (const Cell& c : old) {
+            if (c.device == EMPTY) continue;
+            size_t i = hash(c.device, c.instant) & mask;
+            while (cells[i].device != EMPTY) i = (i + 1) & mask;
+            cells[i] = c;
+        }
+    }
+};
+
+#endif // TIMELINE_INDEX_H
@@ -0,0 +1,305 @@
+/**
+ * @file TraceIngestor.h
+ * @brief Bulk ingestion of recorded sensor traces into SmartHomeSim.
+ *
+ * The `TraceIngestor` class replays a recorded trace file through the sensor
+ * registry at full speed. The file is memory-mapped (read into one buffer on
+ * platforms without mmap) and parsed in place in large batches, without any
+ * per-line allocation. Two formats are accepted:
+ *
+ * - CSV text: one reading per line, either `time,value` (for a default sensor)
+ *   or `time,sensor-id,value`. Blank lines, `#` comments and a header line are skipped.
+ * - Binary: the 8-byte header "SHTRACE1" followed by packed little-endian records
+ *   of { int32 time; int32 sensor handle; float32 value }.
+ *
+ * Trace times are relative to the simulated time at which ingestion starts. CSV
+ * times are seconds and may be fractional (`12.25`) or carry a unit (`250ms`);
+ * binary times are whole seconds. Readings that share a timestamp are published
+ * as one group: time is advanced once, through a hook that lets the simulation
+ * run whatever falls due on the way, and the device changes they cause are
+ * delivered to observers together before time moves on. Time never moves
+ * backwards: a reading earlier than the clock at ingestion start or than the
+ * reading before it is counted as skipped and not delivered.
+ *
+ * Responsibilities:
+ * - Map the trace file and parse it in batches
+ * - Resolve sensor IDs without allocating
+ * - Publish readings grouped by timestamp with the simulated clock set to it
+ * - Report readings/sec and the simulated time covered
+ */
+
+#ifndef TRACE_INGESTOR_H
+#define TRACE_INGESTOR_H
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "MappedFile.h"
+#include "SimClock.h"
+#include "../models/SmartDevice.h"
+#include "../models/sensor/SensorRegistry.h"
+
+class TraceIngestor {
+public:
+    /**
+     * @brief Outcome of one ingestion run.
+     */
+    using AdvanceHook = std::function<void(SimTime)>;  ///< Moves simulated time forward to the given instant
+
+    struct Result {
+        bool ok = false;            ///< Whether the file could be read
+        long long readings = 0;     ///< Readings published
+        long long skipped = 0;      ///< Malformed lines, unknown sensors or out-of-order times
+        SimTime firstTime = 0;      ///< Simulated time of the first reading
+        SimTime lastTime = 0;       ///< Simulated time of the last reading
+        double seconds = 0.0;       ///< Wall-clock time spent
+    };
+
+private:
+    static constexpr char BINARY_MAGIC[8] = {'S', 'H', 'T', 'R', 'A', 'C', 'E', '1'};
+    static constexpr size_t BATCH = 4096;  ///< Readings parsed before they are published
+
+    /**
+     * @brief One parsed reading waiting to be published.
+     */
+    struct Pending {
+        SimTime time;
+        Sensor* sensor;
+        SensorReading reading;
+    };
+
+    SensorRegistry& registry;
+    AdvanceHook advance;                                       ///< Called before each new timestamp group
+    std::vector<Pending> batch;                                ///< Reused batch buffer
+    SimTime lastQueued = 0;                                    ///< Time of the last accepted reading
+    std::vector<std::pair<std::string, Sensor*>> idCache;      ///< Sensor IDs resolved so far
+
+public:
+    /**
+     * @brief Constructs an ingestor publishing into the given registry.
+     * @param sensors Registry the trace's sensor IDs are resolved in
+     * @param advanceTo Moves simulated time to a group's timestamp; by default only the clock is set
+     */
+    explicit TraceIngestor(SensorRegistry& sensors, AdvanceHook advanceTo = SimClock::set)
+        : registry(sensors), advance(std::move(advanceTo)) { batch.reserve(BATCH); }
+
+    /**
+     * @brief Ingests a trace file.
+     *
+     * Console output of sensors and devices is muted while the trace is replayed.
+     *
+     * @param path Trace file (CSV or binary)
+     * @param defaultSensor Sensor used for two-column CSV lines (may be nullptr)
+     * @param startTime Simulated time that trace time 0 maps to
+     * @return Counters and timings of the run
+     */
+    Result ingest(const std::string& path, Sensor* defaultSensor, SimTime startTime) {
+        Result result;
+        MappedFile file(path);
+        if (!file.isOpen()) return result;
+        result.ok = true;
+        result.firstTime = result.lastTime = startTime;
+        lastQueued = SimClock::now();
+
+        auto begin = std::chrono::steady_clock::now();
+        std::ios::iostate coutState = std::cout.rdstate();
+        std::cout.setstate(std::ios::badbit);  // Mute per-reading console output
+
+        if (file.size() >= sizeof(BINARY_MAGIC) && std::memcmp(file.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+            ingestBinary(file, startTime, result);
+        } else {
+            ingestCsv(file, defaultSensor, startTime, result);
+        }
+
+        std::cout.clear(coutState);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    }
+
+    /**
+     * @brief Prints a run's throughput report.
+     */
+    static void printResult(const std::string& path, const Result& r) {
+        if (!r.ok) {
+            std::cout << "[Ingest] Error: cannot read \"" << path << "\".\n";
+            return;
+        }
+        std::cout << "[Ingest] " << r.readings << " readings from \"" << path << "\" in "
+                  << r.seconds * 1000.0 << " ms";
+        if (r.seconds > 0.0) std::cout << " (" << static_cast<long long>(r.readings / r.seconds) << " readings/s)";
+        std::cout << "\n[Ingest] Simulated time covered: t=" << SimClock::format(r.firstTime) << " .. t="
+                  << SimClock::format(r.lastTime) << " (" << SimClock::format(r.lastTime - r.firstTime) << ")";
+        if (r.skipped > 0) std::cout << ", " << r.skipped << " lines skipped";
+        std::cout << "\n";
+    }
+
+private:
+    /**
+     * @brief Parses a CSV trace in place, one line at a time, publishing in batches.
+     */
+    void ingestCsv(const MappedFile& file, Sensor* defaultSensor, SimTime startTime, Result& result) {
+        const char* p = file.data();
+        const char* end = p + file.size();
+        bool first = true;
+
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!eol) eol = end;
+            std::string_view line(p, static_cast<size_t>(eol - p));
+            p = eol + 1;
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty() || line.front() == '#') continue;
+
+            Pending rec;
+            if (!parseCsvLine(line, defaultSensor, rec)) {
+                if (!first) result.skipped++;  // The first bad line is taken as a header
+                first = false;
+                continue;
+            }
+            first = false;
+            rec.time += startTime;
+            enqueue(rec, result);
+        }
+        flush(result);
+    }
+
+    /**
+     * @brief Decodes a binary trace directly from the mapped bytes.
+     */
+    void ingestBinary(const MappedFile& file, SimTime startTime, Result& result) {
+        constexpr size_t RECORD = 12;
+        const char* p = file.data() + sizeof(BINARY_MAGIC);
+        size_t count = (file.size() - sizeof(BINARY_MAGIC)) / RECORD;
+        const auto& sensors = registry.all();
+
+        for (size_t i = 0; i < count; ++i, p += RECORD) {
+            int32_t time, handle;
+            float value;
+            std::memcpy(&time, p, 4);
+            std::memcpy(&handle, p + 4, 4);
+            std::memcpy(&value, p + 8, 4);
+            if (handle < 0 || handle >= static_cast<int32_t>(sensors.size())) {
+                result.skipped++;
+                continue;
+            }
+            Sensor* s = sensors[handle].get();
+            enqueue(Pending{startTime + SimClock::fromSeconds(time), s, makeReading(*s, value)}, result);
+        }
+        flush(result);
+    }
+
+    /**
+     * @brief Queues a reading, or skips it if its time lies before the last accepted one.
+     */
+    void enqueue(const Pending& rec, Result& result) {
+        if (rec.time < lastQueued) {
+            result.skipped++;
+            return;
+        }
+        lastQueued = rec.time;
+        batch.push_back(rec);
+        if (batch.size() == BATCH) flush(result);
+    }
+
+    /**
+     * @brief Publishes the pending batch in order, one timestamp group at a time.
+     *
+     * Time only moves between groups. Device changes caused by a group are
+     * flushed to observers before time moves, so they carry the group's time.
+     */
+    void flush(Result& result) {
+        if (batch.empty()) return;
+        if (result.readings == 0) result.firstTime = batch.front().time;
+        SmartDevice::beginNotificationBatch();
+        for (const Pending& rec : batch) {
+            if (rec.time != SimClock::now()) {
+                SmartDevice::flushNotifications();
+                advance(rec.time);
+            }
+            rec.sensor->publish(rec.reading);
+        }
+        SmartDevice::endNotificationBatch();
+        result.lastTime = batch.back().time;
+        result.readings += static_cast<long long>(batch.size());
+        batch.clear();
+    }
+
+    /**
+     * @brief Parses "time,value" or "time,sensor-id,value" without allocating.
+     */
+    bool parseCsvLine(std::string_view line, Sensor* defaultSensor, Pending& out) {
+        size_t c1 = line.find(',');
+        if (c1 == std::string_view::npos) return false;
+        size_t c2 = line.find(',', c1 + 1);
+
+        if (!parseTime(line.substr(0, c1), out.time)) return false;
+        std::string_view valueText;
+        if (c2 == std::string_view::npos) {
+            out.sensor = defaultSensor;
+            valueText = line.substr(c1 + 1);
+        } else {
+            out.sensor = resolve(line.substr(c1 + 1, c2 - c1 - 1));
+            valueText = line.substr(c2 + 1);
+        }
+        if (!out.sensor) return false;
+
+        float value;
+        if (valueText == "true" || valueText == "on") value = 1.0f;
+        else if (valueText == "false" || valueText == "off") value = 0.0f;
+        else if (!parseNumber(valueText, value)) return false;
+        out.reading = makeReading(*out.sensor, value);
+        return true;
+    }
+
+    /**
+     * @brief Finds a sensor by ID, caching hits so repeated IDs cost one compare.
+     */
+    Sensor* resolve(std::string_view id) {
+        for (const auto& [name, sensor] : idCache) {
+            if (name == id) return sensor;
+        }
+        Sensor* s = registry.find(std::string(id));  // Allocates only on first sight of an ID
+        if (s) idCache.push_back({std::string(id), s});
+        return s;
+    }
+
+    /**
+     * @brief Builds a reading of the sensor's natural type from a parsed number.
+     */
+    static SensorReading makeReading(const Sensor& sensor, float value) {
+        switch (readingTypeOf(sensor.getKind())) {
+            case SensorReading::Type::Int: return SensorReading::ofInt(static_cast<int>(value));
+            case SensorReading::Type::Bool: return SensorReading::ofBool(value != 0.0f);
+            default: return SensorReading::ofFloat(value);
+        }
+    }
+
+    template <typename T>
+    static bool parseNumber(std::string_view text, T& out) {
+        text = trim(text);
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+        return ec == std::errc() && ptr == text.data() + text.size();
+    }
+
+    /**
+     * @brief Parses a trace time ("12", "12.25", "250ms") into a SimTime.
+     */
+    static bool parseTime(std::string_view text, SimTime& out) {
+        return SimClock::parseDuration(trim(text), out);
+    }
+
+    static std::string_view trim(std::string_view text) {
+        while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+        while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+        return text;
+    }
+};
+
+#endif // TRACE_INGESTOR_H